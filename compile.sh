@@ -1 +1 @@
-g++ main.cpp -Wall -Werror && ./a.out
+g++ main.cpp -Wall -Werror -pthread && ./a.out
@@ -34,990 +34,5642 @@
 #include <iomanip>
 #include <algorithm>
 #include <type_traits>
+#include <memory>
+#include <condition_variable>
+#include <charconv>
+#include <cctype>
+#include <cstdint>
+#include <limits>
+#include <cmath>
+#include <functional>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <deque>
+#include <unordered_set>
+#include <unordered_map>
+#include <string_view>
+#include <exception>
+#include <optional>
+#include <tuple>
+#include <array>
+
+// Compressed CSV support is opt-in, since it needs linking against the codec libraries:
+// define LESSER_PANDAS_WITH_ZLIB (link with -lz) and/or LESSER_PANDAS_WITH_ZSTD (link with -lzstd).
+#ifdef LESSER_PANDAS_WITH_ZLIB
+#include <zlib.h>
+#endif
+#ifdef LESSER_PANDAS_WITH_ZSTD
+#include <zstd.h>
+#endif
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 using namespace std;
 
 /**
- * @brief Represents a single column in a DataFrame with associated operations.
- * 
- * The Column class stores data as strings internally but can handle different data types
- * (int, float, string) through automatic type detection and conversion. It provides
- * statistical operations, filtering, and data manipulation methods.
+ * @brief Parses a numeric cell without allocating or throwing.
+ *
+ * @param s The string to parse
+ * @param out Receives the parsed value on success
+ * @return True if the whole string is a number, false for missing or non-numeric values
+ * @note Leading whitespace and a leading '+' are accepted, matching `stod`. NaN is treated as missing.
  */
-class Column {
-public:
-    string name; // column's name
-    vector<string> data; // column's data
-    string dtype = "string"; // data type
-    friend std::ostream& operator<<(std::ostream& os, const Column& col);
+bool parse_number(const string& s, double& out) {
+    const char* first = s.data();
+    const char* last = first + s.size();
+    while (first != last && isspace(static_cast<unsigned char>(*first))) {
+        first++;
+    }
+    if (first != last && *first == '+') {
+        first++;
+    }
+    if (first == last) {
+        return false;
+    }
+    auto [ptr, ec] = from_chars(first, last, out);
+    return ec == errc() && ptr == last && out == out;
+}
 
-    /**
-     * @brief Prints the column data with optional row limiting and tail functionality.
-     * 
-     * @param rows_cnt Number of rows to print (0 = print all rows)
-     * @param is_tail If true, prints the last N rows instead of first N rows
-     */
-    void print(int rows_cnt = 0, bool is_tail = false) const {
-        if (data.size() == 0) {
-            return;
+/**
+ * @brief Parses an integer cell without allocating or throwing.
+ *
+ * @tparam T The integer type to parse into; cells out of its range fail
+ * @param s The string to parse
+ * @param out Receives the parsed value on success
+ * @return True if the whole string is a base-10 integer, false for missing or non-integer values
+ * @note Leading whitespace and a leading '+' or '-' are accepted, matching `stoi`.
+ */
+template <typename T>
+bool parse_integer(const string& s, T& out) {
+    const char* first = s.data();
+    const char* last = first + s.size();
+    while (first != last && isspace(static_cast<unsigned char>(*first))) {
+        first++;
+    }
+    if (first != last && *first == '+') {
+        first++;
+        if (first != last && *first == '-') {
+            return false;
         }
+    }
+    if (first == last) {
+        return false;
+    }
+    auto [ptr, ec] = from_chars(first, last, out);
+    return ec == errc() && ptr == last;
+}
 
-        if (rows_cnt == 0) {
-            rows_cnt = data.size()-1;
-        }
+/**
+ * @brief Formats a number with the shortest representation that parses back to the same value.
+ *
+ * @param num The value to format
+ * @return The formatted number, or an empty string (missing value) for NaN
+ */
+string format_number(double num) {
+    if (num != num) {
+        return "";
+    }
+    char buf[32];
+    auto [ptr, ec] = to_chars(buf, buf + sizeof(buf), num);
+    return string(buf, ptr);
+}
 
-        cout << name << endl;
+const int64_t NAT = numeric_limits<int64_t>::min(); // missing datetime value
 
-        for(size_t i = 0; i < name.length(); i++) {
-            cout << '-';
+/**
+ * @brief Number of days from 1970-01-01 to a proleptic Gregorian date.
+ */
+int64_t days_from_civil(int64_t y, unsigned m, unsigned d) {
+    y -= m <= 2;
+    int64_t era = (y >= 0 ? y : y - 399) / 400;
+    unsigned yoe = static_cast<unsigned>(y - era * 400);
+    unsigned doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;
+    unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + static_cast<int64_t>(doe) - 719468;
+}
+
+/**
+ * @brief Parses an ISO-8601 timestamp into nanoseconds since the Unix epoch, without locales or allocation.
+ *
+ * Accepts `YYYY-MM-DD`, optionally followed by `T` or a space and `HH:MM`, `HH:MM:SS` or
+ * `HH:MM:SS.fffffffff`, optionally followed by `Z` or a `+HH:MM` / `-HHMM` offset.
+ *
+ * @param s The string to parse
+ * @param out Receives the timestamp (UTC) on success
+ * @return False for missing values, malformed timestamps and years outside 1678-2261
+ */
+bool parse_datetime(string_view s, int64_t& out) {
+    size_t pos = 0;
+    auto digits = [&](size_t n, int& value) {
+        if (pos + n > s.size()) {
+            return false;
         }
+        value = 0;
+        for (size_t end = pos + n; pos < end; pos++) {
+            if (s[pos] < '0' || s[pos] > '9') {
+                return false;
+            }
+            value = value * 10 + (s[pos] - '0');
+        }
+        return true;
+    };
+    auto literal = [&](char c) {
+        if (pos < s.size() && s[pos] == c) {
+            pos++;
+            return true;
+        }
+        return false;
+    };
 
-        cout << endl;
+    int year, month, day, hour = 0, minute = 0, second = 0;
+    if (!digits(4, year) || !literal('-') || !digits(2, month) || !literal('-') || !digits(2, day)) {
+        return false;
+    }
+    static const int month_days[] = {31, 29, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    bool leap = year % 4 == 0 && (year % 100 != 0 || year % 400 == 0);
+    if (year < 1678 || year > 2261 || month < 1 || month > 12 || day < 1 || day > month_days[month - 1]
+        || (month == 2 && day == 29 && !leap)) {
+        return false;
+    }
 
-        if (is_tail) {
-            for(size_t idx = data.size()-rows_cnt; idx < data.size(); idx++) {
-                cout << data[idx] << endl;
+    int64_t fraction = 0;
+    int64_t offset = 0;
+    if (pos < s.size()) {
+        if (!(literal('T') || literal(' ')) || !digits(2, hour) || !literal(':') || !digits(2, minute)) {
+            return false;
+        }
+        if (literal(':')) {
+            if (!digits(2, second)) {
+                return false;
             }
-        } else {
-            for(int idx = 0; idx < rows_cnt; idx++) {
-                cout << data[idx] << endl;
+            if (literal('.')) {
+                size_t start = pos;
+                for (; pos < s.size() && s[pos] >= '0' && s[pos] <= '9'; pos++) {
+                    if (pos - start < 9) {
+                        fraction = fraction * 10 + (s[pos] - '0');
+                    }
+                }
+                if (pos == start) {
+                    return false;
+                }
+                for (size_t n = pos - start; n < 9; n++) {
+                    fraction *= 10;
+                }
             }
         }
+        if (hour > 23 || minute > 59 || second > 59) {
+            return false;
+        }
 
-        cout << "\nPrinted: " << rows_cnt << " rows\n";
+        if (literal('Z')) {
+        } else if (pos < s.size() && (s[pos] == '+' || s[pos] == '-')) {
+            int sign = s[pos++] == '-' ? -1 : 1;
+            int off_hour, off_minute;
+            if (!digits(2, off_hour)) {
+                return false;
+            }
+            literal(':');
+            if (!digits(2, off_minute) || off_hour > 23 || off_minute > 59) {
+                return false;
+            }
+            offset = sign * (off_hour * 3600 + off_minute * 60);
+        }
+        if (pos != s.size()) {
+            return false;
+        }
     }
 
-    /**
-     * @brief Displays the first N rows of the column.
-     * 
-     * @param rows_cnt Number of rows to display from the beginning (default: 5)
-     */
-    void head(int rows_cnt = 5) const {
-        print(rows_cnt);
-    }
+    int64_t seconds = days_from_civil(year, month, day) * 86400 + hour * 3600 + minute * 60 + second - offset;
+    out = seconds * 1000000000 + fraction;
+    return true;
+}
 
-    /**
-     * @brief Displays the last N rows of the column.
-     * 
-     * @param rows_cnt Number of rows to display from the end (default: 5)
-     */
-    void tail(int rows_cnt = 5) const {
-        print(rows_cnt, true);
+/**
+ * @brief Formats nanoseconds since the Unix epoch as `YYYY-MM-DD HH:MM:SS[.fffffffff]` (UTC).
+ *
+ * @param ns The timestamp
+ * @return The formatted timestamp with trailing zeros of the fraction removed, or an empty string for NAT
+ */
+string format_datetime(int64_t ns) {
+    if (ns == NAT) {
+        return "";
+    }
+    const int64_t NS_PER_DAY = 86400LL * 1000000000;
+    int64_t days = ns / NS_PER_DAY;
+    int64_t rem = ns % NS_PER_DAY;
+    if (rem < 0) {
+        rem += NS_PER_DAY;
+        days--;
     }
 
-    /**
-     * @brief Calculates the arithmetic mean of numeric column data.
-     * 
-     * @return The mean value as a double
-     * @throws invalid_argument If the column dtype is not "int" or "float"
-     * @note Empty/missing values are excluded from the calculation
-     */
-    double mean() const {
-        if (dtype == "int" || dtype == "float") {
-            double sum = 0;
-            double col_size = static_cast<double> (data.size());
-            for(const string& element : data) {
-                if (element.length() == 0) {
-                    // missing element
-                    col_size--;
-                    continue;
-                }
-                double num = stod(element);
-                sum += num;
-            }
-            return sum / col_size;
+    // inverse of days_from_civil
+    days += 719468;
+    int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+    unsigned doe = static_cast<unsigned>(days - era * 146097);
+    unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    unsigned mp = (5 * doy + 2) / 153;
+    unsigned day = doy - (153 * mp + 2) / 5 + 1;
+    unsigned month = mp < 10 ? mp + 3 : mp - 9;
+    int64_t year = static_cast<int64_t>(yoe) + era * 400 + (month <= 2);
+
+    int64_t secs = rem / 1000000000;
+    int64_t fraction = rem % 1000000000;
+    char buf[48];
+    int len = snprintf(buf, sizeof(buf), "%04lld-%02u-%02u %02lld:%02lld:%02lld", static_cast<long long>(year), month, day,
+                       static_cast<long long>(secs / 3600), static_cast<long long>(secs / 60 % 60), static_cast<long long>(secs % 60));
+    if (fraction != 0) {
+        int digits = 9;
+        while (fraction % 10 == 0) {
+            fraction /= 10;
+            digits--;
         }
+        len += snprintf(buf + len, sizeof(buf) - len, ".%0*lld", digits, static_cast<long long>(fraction));
+    }
+    return string(buf, len);
+}
 
-        throw invalid_argument("Invalid type: Column::mean() expects `dtype` to be int or float");
+/**
+ * @brief Parses a frequency such as "1h", "15min", "30s", "1d", "100ms", "1us" or "1ns" into nanoseconds.
+ *
+ * @throws invalid_argument If the frequency is malformed, not positive, or has an unknown unit
+ */
+int64_t parse_frequency(const string& freq) {
+    size_t unit_start = 0;
+    while (unit_start < freq.size() && isdigit(static_cast<unsigned char>(freq[unit_start]))) {
+        unit_start++;
     }
+    int64_t count = unit_start == 0 ? 1 : 0;
+    from_chars(freq.data(), freq.data() + unit_start, count);
 
-    /**
-     * @brief Calculates the sum of the column data.
-     * 
-     * @return The sum value as a double
-     * @throws invalid_argument If the column dtype is not "int" or "float"
-     * @note Empty/missing values are excluded from the calculation
-     */
-    double sum() const {
-        if (dtype == "int" || dtype == "float") {
-            double sum = 0;
-            for(const string& element : data) {
-                if (element.length() == 0) {
-                    // missing element
-                    continue;
-                }
-                double num = stod(element);
-                sum += num;
-            }
-            return sum;
+    static const pair<const char*, int64_t> units[] = {
+        {"ns", 1}, {"us", 1000}, {"ms", 1000000}, {"s", 1000000000}, {"min", 60000000000},
+        {"h", 3600000000000}, {"d", 86400000000000},
+    };
+    string unit = freq.substr(unit_start);
+    transform(unit.begin(), unit.end(), unit.begin(), [](unsigned char c) { return tolower(c); });
+    for (const auto& [name, ns] : units) {
+        if (unit == name && count > 0) {
+            return count * ns;
         }
+    }
+    throw invalid_argument("Invalid argument: unknown frequency `" + freq + "`");
+}
 
-        throw invalid_argument("Invalid type: Column::mean() expects `dtype` to be int or float");
+/**
+ * @brief Storage for a column's cells that records every modification.
+ *
+ * Reads go through a const view of the underlying `vector<string>`; writes only through the
+ * methods below, each of which bumps a version number, so cached metadata derived from the data
+ * (such as zone maps) can detect that it is stale. No mutable reference to a cell outlives the call
+ * that made it.
+ */
+class ColumnData {
+private:
+    vector<string> cells;
+    uint64_t version_ = 0;
+
+    void touch() {
+        version_++;
     }
-    
-    /**
-     * @brief Returns a sorted copy of the column data in ascending order.
-     * 
-     * @return Vector of strings containing sorted numeric values
-     * @throws invalid_argument If the column dtype is "string"
-     * @note The original column data remains unchanged
-     */
-    vector<string> sorted() const {
-        if (dtype == "string") {
-            throw invalid_argument("Invalid type: Column::Sorted() expects `dtype` to be int or float");
-        }
-        vector<string> result = data;
 
-        std::sort(result.begin(), result.end(), [](string &s1, string &s2) {
-            return stod(s1) < stod(s2);
-        });
-        
-        return result;
+public:
+    using const_iterator = vector<string>::const_iterator;
+
+    ColumnData() = default;
+    ColumnData(const ColumnData& other) = default;
+    ColumnData(ColumnData&& other) = default;
+    ColumnData(const vector<string>& other) : cells(other) {}
+    ColumnData(vector<string>&& other) : cells(std::move(other)) {}
+    ColumnData(initializer_list<string> init) : cells(init) {}
+
+    ColumnData& operator=(const ColumnData& other) {
+        cells = other.cells;
+        version_ = std::max(version_, other.version_) + 1;
+        return *this;
+    }
+
+    ColumnData& operator=(ColumnData&& other) {
+        cells = std::move(other.cells);
+        version_ = std::max(version_, other.version_) + 1;
+        other.touch();
+        return *this;
+    }
+
+    ColumnData& operator=(const vector<string>& other) {
+        cells = other;
+        touch();
+        return *this;
+    }
+
+    ColumnData& operator=(vector<string>&& other) {
+        cells = std::move(other);
+        touch();
+        return *this;
     }
 
     /**
-     * @brief Finds the minimum value in the column.
-     * 
-     * @return The minimum value as a double
-     * @throws invalid_argument If the column dtype is "string"
+     * @brief Returns a number that changes whenever the data has been modified.
      */
-    double min() {
-        if (dtype == "string") {
-            throw invalid_argument("Invalid type: Column::min() expects `dtype` to be int or float");
-        }
-        vector<string> sorted_col = sorted();
-        double mn = stod(sorted_col[0]);
-
-        return mn;
+    uint64_t version() const {
+        return version_;
     }
 
     /**
-     * @brief Finds the maximum value in the column.
-     * 
-     * @return The maximum value as a double
-     * @throws invalid_argument If the column dtype is "string"
+     * @brief Read-only view of the cells.
      */
-    double max() {
-        if (dtype == "string") {
-            throw invalid_argument("Invalid type: Column::max() expects `dtype` to be int or float");
-        }
-        vector<string> sorted_col = sorted();
-        double mx = stod(sorted_col[sorted_col.size()-1]);
+    const vector<string>& values() const {
+        return cells;
+    }
 
-        return mx;
+    operator const vector<string>&() const {
+        return cells;
     }
 
+    size_t size() const { return cells.size(); }
+    bool empty() const { return cells.empty(); }
+    const string& operator[](size_t idx) const { return cells[idx]; }
+    const string& at(size_t idx) const { return cells.at(idx); }
+    const_iterator begin() const { return cells.begin(); }
+    const_iterator end() const { return cells.end(); }
+
     /**
-     * @brief Fills missing (empty) values in the column with a specified value.
-     * 
-     * @tparam T The type of the fill value (int, double, or string)
-     * @param x The value to use for filling missing entries
-     * @note For numeric types, the value is converted to string representation
+     * @brief Replaces the cell at `idx`.
      */
-    template <typename T>
-    void fillna(T x) {
-        for (string &element : data) {
-            if (element.length() == 0) {
-                // missing element
-                if (is_same<T, int>::value || is_same<T, double>::value) {
-                    if (dtype == "int") {
-                        x = static_cast<int>(x);
-                    }
-                    element = to_string(x);
-                } else {
-                    element = x;
-                }
-            }
-        }
+    void set(size_t idx, string value) {
+        touch();
+        cells.at(idx) = std::move(value);
+    }
+
+    void push_back(string value) {
+        touch();
+        cells.push_back(std::move(value));
     }
 
     /**
-     * @brief Equality comparison operator for numeric columns.
-     * 
-     * @param key The numeric value to compare against
-     * @return Vector of boolean values indicating which elements equal the key
-     * @throws runtime_error If the column dtype is "string"
+     * @brief Appends the cells in [first, last) at the end.
      */
-    vector<bool> operator==(const double& key) const {
-        if (dtype == "string") {
-           throw runtime_error("Error: Invalid comparison");
-        }
+    template <typename It>
+    void append(It first, It last) {
+        touch();
+        cells.insert(cells.end(), first, last);
+    }
 
-        vector<bool> mask(data.size());
-        for (size_t i = 0; i < data.size(); i++) {
-            try {
-                if (data[i].empty()) {
-                    mask[i] = false; 
-                } else {
-                    mask[i] = (stod(data[i]) == key); 
-                }
-            } catch (...) {
-                mask[i] = false; 
-            }
-        }
-        return mask;
-    } 
+    void reserve(size_t n) {
+        cells.reserve(n);
+    }
+
+    void resize(size_t n) {
+        touch();
+        cells.resize(n);
+    }
+
+    void clear() {
+        touch();
+        cells.clear();
+    }
 
     /**
-     * @brief Inequality comparison operator for numeric columns.
-     * 
-     * @param key The numeric value to compare against
-     * @return Vector of boolean values indicating which elements are not equal to the key
-     * @throws runtime_error If the column dtype is "string"
+     * @brief Moves the cells out, leaving the column empty.
      */
-    vector<bool> operator!=(const double& key) {
-        if (dtype == "string") {
-           throw runtime_error("Error: Invalid comparison");
-        }
-
-        vector<bool> mask(data.size());
-        for (size_t i = 0; i < data.size(); i++) {
-            try {
-                if (data[i].empty()) {
-                    mask[i] = false; 
-                } else {
-                    mask[i] = (stod(data[i]) != key); 
-                }
-            } catch (...) {
-                mask[i] = false; 
-            }
-        }
-        return mask;
+    vector<string> release() {
+        touch();
+        vector<string> out = std::move(cells);
+        cells.clear();
+        return out;
     }
 
     /**
-     * @brief Less-than comparison operator for numeric columns.
-     * 
-     * @param key The numeric value to compare against
-     * @return Vector of boolean values indicating which elements are less than the key
-     * @throws runtime_error If the column dtype is "string"
+     * @brief Runs `edit` with mutable access to the cells for an in-place bulk update.
+     *
+     * The version is bumped before and after, so the reference must not be kept past `edit`.
      */
-    vector<bool> operator<(const double& key) {
-        if (dtype == "string") {
-           throw runtime_error("Error: Invalid comparison");
+    template <typename F>
+    void update(F&& edit) {
+        touch();
+        edit(cells);
+        touch();
+    }
+};
+
+/**
+ * @brief Runs `fn(i)` for every i in [0, n) on a pool of worker threads.
+ *
+ * @param n Number of tasks
+ * @param fn Task body; tasks must be independent of each other
+ * @note The first exception thrown by a task is rethrown on the calling thread
+ */
+template <typename Fn>
+void parallel_for(size_t n, Fn fn) {
+    size_t workers = std::min<size_t>(n, std::max(1u, thread::hardware_concurrency()));
+    if (workers <= 1) {
+        for (size_t i = 0; i < n; i++) {
+            fn(i);
         }
+        return;
+    }
 
-        vector<bool> mask(data.size());
-        for (size_t i = 0; i < data.size(); i++) {
+    atomic<size_t> next(0);
+    exception_ptr error;
+    mutex error_lock;
+    vector<thread> pool;
+    for (size_t w = 0; w < workers; w++) {
+        pool.emplace_back([&]() {
             try {
-                if (data[i].empty()) {
-                    mask[i] = false; 
-                } else {
-                    mask[i] = (stod(data[i]) < key); 
+                for (size_t i = next++; i < n; i = next++) {
+                    fn(i);
                 }
             } catch (...) {
-                mask[i] = false; 
+                lock_guard<mutex> guard(error_lock);
+                if (!error) {
+                    error = current_exception();
+                }
             }
-        }
-        return mask;
+        });
+    }
+    for (thread& worker : pool) {
+        worker.join();
+    }
+    if (error) {
+        rethrow_exception(error);
     }
+}
 
-    /**
-     * @brief Greater-than comparison operator for numeric columns.
-     * 
-     * @param key The numeric value to compare against
-     * @return Vector of boolean values indicating which elements are greater than the key
-     * @throws runtime_error If the column dtype is "string"
-     */
-    vector<bool> operator>(const double& key) {
-        if (dtype == "string") {
-           throw runtime_error("Error: Invalid comparison");
-        }
+/**
+ * @brief Min/max/null-count statistics for one block of rows in a numeric column.
+ */
+struct ZoneMap {
+    double min = numeric_limits<double>::infinity();
+    double max = -numeric_limits<double>::infinity();
+    size_t null_count = 0; // missing or non-numeric cells
+    size_t rows = 0;
 
-        vector<bool> mask(data.size());
-        for (size_t i = 0; i < data.size(); i++) {
-            try {
-                if (data[i].empty()) {
-                    mask[i] = false; 
-                } else {
-                    mask[i] = (stod(data[i]) > key); 
-                }
-            } catch (...) {
-                mask[i] = false; 
+    void add(double num) {
+        rows++;
+        min = std::min(min, num);
+        max = std::max(max, num);
+    }
+
+    void add_null() {
+        rows++;
+        null_count++;
+    }
+};
+
+/**
+ * @brief Scrambles a hash value so that its low bits are well distributed (splitmix64 finalizer).
+ */
+uint64_t mix_hash(uint64_t h) {
+    h ^= h >> 30;
+    h *= 0xbf58476d1ce4e5b9ULL;
+    h ^= h >> 27;
+    h *= 0x94d049bb133111ebULL;
+    h ^= h >> 31;
+    return h;
+}
+
+/**
+ * @brief Groups rows with equal keys, hash-partitioning the work across threads.
+ *
+ * Rows are split into partitions by hash, and each partition is grouped by its own thread
+ * with a hash table of row indices, so keys are never copied or concatenated.
+ *
+ * @param hashes Hash of every row's key
+ * @param equal Returns true if the rows at two indices have equal keys
+ * @param reverse If true, rows are visited from last to first
+ * @return For every group, the index of its first visited row and the number of rows in it
+ */
+template <typename Equal>
+vector<pair<size_t, size_t>> group_rows(const vector<uint64_t>& hashes, Equal equal, bool reverse = false) {
+    const size_t PARALLEL_MIN_ROWS = 1 << 16;
+    size_t n = hashes.size();
+    size_t parts = n < PARALLEL_MIN_ROWS ? 1 : std::max(1u, thread::hardware_concurrency());
+
+    struct RowHash {
+        const vector<uint64_t>* hashes;
+        size_t operator()(size_t row) const { return (*hashes)[row]; }
+    };
+    struct RowEqual {
+        const vector<uint64_t>* hashes;
+        const Equal* equal;
+        bool operator()(size_t a, size_t b) const { return (*hashes)[a] == (*hashes)[b] && (*equal)(a, b); }
+    };
+
+    vector<vector<pair<size_t, size_t>>> groups(parts);
+    parallel_for(parts, [&](size_t part) {
+        unordered_map<size_t, size_t, RowHash, RowEqual> group_of(16, RowHash{&hashes}, RowEqual{&hashes, &equal});
+        auto visit = [&](size_t row) {
+            if ((hashes[row] >> 32) % parts != part) {
+                return;
+            }
+            auto [it, inserted] = group_of.emplace(row, groups[part].size());
+            if (inserted) {
+                groups[part].push_back({row, 1});
+            } else {
+                groups[part][it->second].second++;
+            }
+        };
+        if (reverse) {
+            for (size_t row = n; row-- > 0;) {
+                visit(row);
+            }
+        } else {
+            for (size_t row = 0; row < n; row++) {
+                visit(row);
             }
         }
-        return mask;
+    });
+
+    vector<pair<size_t, size_t>> result;
+    for (const auto& part : groups) {
+        result.insert(result.end(), part.begin(), part.end());
     }
+    return result;
+}
+
+/**
+ * @brief HyperLogLog sketch estimating the number of distinct values in a fixed amount of memory.
+ *
+ * Uses 2^precision one-byte registers. Sketches built over different chunks or threads can be
+ * merged, and the merged estimate equals the estimate over the combined input.
+ */
+class HyperLogLog {
+private:
+    int precision;
+    vector<uint8_t> registers;
 
+public:
     /**
-     * @brief Less-than-or-equal comparison operator for numeric columns.
-     * 
-     * @param key The numeric value to compare against
-     * @return Vector of boolean values indicating which elements are less than or equal to the key
-     * @throws runtime_error If the column dtype is "string"
+     * @param precision Number of index bits, between 4 and 18 (default 12: 4 KiB, ~1.6% error)
+     * @throws invalid_argument If `precision` is out of range
      */
-    vector<bool> operator<=(const double& key) {
-        if (dtype == "string") {
-           throw runtime_error("Error: Invalid comparison");
+    explicit HyperLogLog(int precision = 12) : precision(precision) {
+        if (precision < 4 || precision > 18) {
+            throw invalid_argument("Invalid argument: HyperLogLog expects `precision` between 4 and 18");
         }
+        registers.assign(size_t(1) << precision, 0);
+    }
 
-        vector<bool> mask(data.size());
-        for (size_t i = 0; i < data.size(); i++) {
-            try {
-                if (data[i].empty()) {
-                    mask[i] = false; 
-                } else {
-                    mask[i] = (stod(data[i]) <= key); 
-                }
-            } catch (...) {
-                mask[i] = false; 
-            }
-        }
-        return mask;
+    /**
+     * @brief Adds a value, given by its hash.
+     */
+    void add(uint64_t hash) {
+        uint64_t h = mix_hash(hash);
+        size_t idx = h >> (64 - precision);
+        uint64_t rest = h << precision;
+        uint8_t rank = rest == 0 ? 64 - precision + 1 : __builtin_clzll(rest) + 1;
+        registers[idx] = std::max(registers[idx], rank);
     }
 
     /**
-     * @brief Greater-than-or-equal comparison operator for numeric columns.
-     * 
-     * @param key The numeric value to compare against
-     * @return Vector of boolean values indicating which elements are greater than or equal to the key
-     * @throws runtime_error If the column dtype is "string"
+     * @brief Combines another sketch into this one.
+     *
+     * @throws invalid_argument If the sketches use different precisions
      */
-    vector<bool> operator>=(const double& key) {
-        if (dtype == "string") {
-           throw runtime_error("Error: Invalid comparison");
+    void merge(const HyperLogLog& other) {
+        if (other.precision != precision) {
+            throw invalid_argument("Invalid argument: HyperLogLog::merge() expects equal precisions");
         }
-
-        vector<bool> mask(data.size());
-        for (size_t i = 0; i < data.size(); i++) {
-            try {
-                if (data[i].empty()) {
-                    mask[i] = false; 
-                } else {
-                    mask[i] = (stod(data[i]) >= key); 
-                }
-            } catch (...) {
-                mask[i] = false; 
-            }
+        for (size_t i = 0; i < registers.size(); i++) {
+            registers[i] = std::max(registers[i], other.registers[i]);
         }
-        return mask;
     }
 
     /**
-     * @brief Equality comparison operator for string columns.
-     * 
-     * @param key The string value to compare against
-     * @return Vector of boolean values indicating which elements equal the key
-     * @throws runtime_error If the column dtype is "float" or "int"
+     * @brief Returns the estimated number of distinct values added.
      */
-    vector<bool> operator==(const string& key) {
-        if (dtype == "float" || dtype == "int") {
-           throw runtime_error("Error: Invalid comparison");
+    size_t estimate() const {
+        double m = static_cast<double>(registers.size());
+        double alpha = m == 16 ? 0.673 : m == 32 ? 0.697 : m == 64 ? 0.709 : 0.7213 / (1 + 1.079 / m);
+        double harmonic = 0;
+        size_t zeros = 0;
+        for (uint8_t reg : registers) {
+            harmonic += ldexp(1.0, -reg);
+            zeros += reg == 0;
         }
-
-        vector<bool> mask(data.size());
-        for (size_t i = 0; i < data.size(); i++) {
-            mask[i] = (data[i] == key);
+        double raw = alpha * m * m / harmonic;
+        if (raw <= 2.5 * m && zeros > 0) {
+            // small range correction (linear counting)
+            raw = m * log(m / static_cast<double>(zeros));
         }
-        return mask;
+        return static_cast<size_t>(llround(raw));
     }
 
     /**
-     * @brief Inequality comparison operator for string columns.
-     * 
-     * @param key The string value to compare against
-     * @return Vector of boolean values indicating which elements are not equal to the key
-     * @throws runtime_error If the column dtype is "float" or "int"
+     * @brief Returns the relative standard error of the estimate (1.04 / sqrt(registers)).
      */
-    vector<bool> operator!=(const string& key) {
-        if (dtype == "float" || dtype == "int") {
-           throw runtime_error("Error: Invalid comparison");
-        }
+    double error_bound() const {
+        return 1.04 / sqrt(static_cast<double>(registers.size()));
+    }
+};
 
-        vector<bool> mask(data.size());
-        for (size_t i = 0; i < data.size(); i++) {
-            mask[i] = (data[i] != key);
+/**
+ * @brief KLL sketch answering approximate quantile queries in a small, bounded amount of memory.
+ *
+ * Values are kept in a hierarchy of compactors; when a level fills up, it is sorted and every other
+ * value is promoted to the next level with twice the weight. Sketches built over different chunks or
+ * threads can be merged.
+ */
+class KllSketch {
+private:
+    size_t k;
+    vector<vector<double>> levels;
+    size_t n = 0;
+    double min_value = numeric_limits<double>::infinity();
+    double max_value = -numeric_limits<double>::infinity();
+    uint64_t coin = 0; // state for choosing which half of a level survives
+
+    size_t capacity(size_t level) const {
+        size_t depth = levels.size() - level - 1;
+        return std::max<size_t>(2, static_cast<size_t>(ceil(k * pow(2.0 / 3.0, static_cast<double>(depth)))));
+    }
+
+    void compress() {
+        for (size_t level = 0; level < levels.size(); level++) {
+            if (levels[level].size() < capacity(level)) {
+                continue;
+            }
+            if (level + 1 == levels.size()) {
+                levels.emplace_back();
+            }
+            vector<double>& items = levels[level];
+            std::sort(items.begin(), items.end());
+
+            // promote every other value of an even-sized prefix; an odd last value stays
+            size_t even = items.size() - items.size() % 2;
+            size_t offset = mix_hash(++coin) & 1;
+            for (size_t i = offset; i < even; i += 2) {
+                levels[level + 1].push_back(items[i]);
+            }
+            items.erase(items.begin(), items.begin() + even);
         }
-        return mask;
     }
 
+public:
     /**
-     * @brief Less-than comparison operator for string columns (lexicographic order).
-     * 
-     * @param key The string value to compare against
-     * @return Vector of boolean values indicating which elements are lexicographically less than the key
-     * @throws runtime_error If the column dtype is "float" or "int"
+     * @param k Accuracy parameter; larger values are more accurate and use more memory (default 200)
+     * @throws invalid_argument If `k` is less than 8
      */
-    vector<bool> operator<(const string& key) {
-        if (dtype == "float" || dtype == "int") {
-           throw runtime_error("Error: Invalid comparison");
+    explicit KllSketch(size_t k = 200) : k(k), levels(1) {
+        if (k < 8) {
+            throw invalid_argument("Invalid argument: KllSketch expects `k` to be at least 8");
         }
+    }
 
-        vector<bool> mask(data.size());
-        for (size_t i = 0; i < data.size(); i++) {
-            mask[i] = (data[i] < key);
+    void add(double value) {
+        n++;
+        min_value = std::min(min_value, value);
+        max_value = std::max(max_value, value);
+        levels[0].push_back(value);
+        if (levels[0].size() >= capacity(0)) {
+            compress();
         }
-        return mask;
     }
 
     /**
-     * @brief Greater-than comparison operator for string columns (lexicographic order).
-     * 
-     * @param key The string value to compare against
-     * @return Vector of boolean values indicating which elements are lexicographically greater than the key
-     * @throws runtime_error If the column dtype is "float" or "int"
+     * @brief Combines another sketch into this one.
      */
-    vector<bool> operator>(const string& key) {
-        if (dtype == "float" || dtype == "int") {
-           throw runtime_error("Error: Invalid comparison");
+    void merge(const KllSketch& other) {
+        while (levels.size() < other.levels.size()) {
+            levels.emplace_back();
         }
-
-        vector<bool> mask(data.size());
-        for (size_t i = 0; i < data.size(); i++) {
-            mask[i] = (data[i] > key);
+        for (size_t level = 0; level < other.levels.size(); level++) {
+            levels[level].insert(levels[level].end(), other.levels[level].begin(), other.levels[level].end());
         }
-        return mask;
+        n += other.n;
+        min_value = std::min(min_value, other.min_value);
+        max_value = std::max(max_value, other.max_value);
+        compress();
     }
 
     /**
-     * @brief Less-than-or-equal comparison operator for string columns (lexicographic order).
-     * 
-     * @param key The string value to compare against
-     * @return Vector of boolean values indicating which elements are lexicographically less than or equal to the key
-     * @throws runtime_error If the column dtype is "float" or "int"
+     * @brief Returns the number of values added.
      */
-    vector<bool> operator<=(const string& key) {
-        if (dtype == "float" || dtype == "int") {
-           throw runtime_error("Error: Invalid comparison");
-        }
-
-        vector<bool> mask(data.size());
-        for (size_t i = 0; i < data.size(); i++) {
-            mask[i] = (data[i] <= key);
-        }
-        return mask;
+    size_t count() const {
+        return n;
     }
 
     /**
-     * @brief Greater-than-or-equal comparison operator for string columns (lexicographic order).
-     * 
-     * @param key The string value to compare against
-     * @return Vector of boolean values indicating which elements are lexicographically greater than or equal to the key
-     * @throws runtime_error If the column dtype is "float" or "int"
+     * @brief Returns a value whose rank is approximately `q * count()`.
+     *
+     * @param q Quantile between 0 and 1
+     * @return The approximate quantile, or NaN if the sketch is empty
      */
-    vector<bool> operator>=(const string& key) {
-        if (dtype == "float" || dtype == "int") {
-           throw runtime_error("Error: Invalid comparison");
+    double quantile(double q) const {
+        if (n == 0) {
+            return numeric_limits<double>::quiet_NaN();
+        }
+        if (q <= 0) {
+            return min_value;
+        }
+        if (q >= 1) {
+            return max_value;
         }
 
-        vector<bool> mask(data.size());
-        for (size_t i = 0; i < data.size(); i++) {
-            mask[i] = (data[i] >= key);
+        vector<pair<double, uint64_t>> weighted;
+        for (size_t level = 0; level < levels.size(); level++) {
+            for (double value : levels[level]) {
+                weighted.push_back({value, uint64_t(1) << level});
+            }
         }
-        return mask;
+        std::sort(weighted.begin(), weighted.end());
+
+        uint64_t total = 0;
+        for (const auto& item : weighted) {
+            total += item.second;
+        }
+        double target = q * static_cast<double>(total);
+        uint64_t seen = 0;
+        for (const auto& item : weighted) {
+            seen += item.second;
+            if (static_cast<double>(seen) >= target) {
+                return item.first;
+            }
+        }
+        return max_value;
     }
-};
 
-/**
- * @brief Checks if a string represents a valid integer.
- * 
- * @param s The string to test
- * @return True if the string can be converted to an integer, false otherwise
- */
-bool is_integer(const string& s) {
-    try {
-        size_t pos;
-        stoi(s, &pos);
-        return pos == s.length();
-    } catch (...) {
-        return false;
+    /**
+     * @brief Returns the approximate normalized rank error of quantile() (99% confidence).
+     */
+    double error_bound() const {
+        return 2.296 / pow(static_cast<double>(k), 0.9723);
     }
-}
+};
 
 /**
- * @brief Checks if a string represents a valid floating-point number.
- * 
- * @param s The string to test
- * @return True if the string can be converted to a double, false otherwise
+ * @brief Whole-column summary statistics cached by a Column.
  */
-bool is_float(const string& s) {
-    try {
-        size_t pos;
-        stod(s, &pos);
-        return pos == s.length();
-    } catch (...) {
-        return false;
-    }
-}
+struct ColumnStats {
+    size_t count = 0;      // number of valid values
+    size_t null_count = 0; // missing cells (and unparsable cells in numeric and datetime columns)
+    double sum = 0;        // numeric columns only
+    double min = numeric_limits<double>::infinity();  // numeric columns only
+    double max = -numeric_limits<double>::infinity(); // numeric columns only
+    bool sorted = true;    // valid values are in non-decreasing order
+    size_t distinct = 0;   // estimated number of distinct valid values
+};
 
 /**
- * @brief A DataFrame class for handling tabular data similar to pandas DataFrame.
- * 
- * The DataFrame class provides functionality to load CSV files, manipulate data,
- * perform filtering operations, and save results. It automatically detects column
- * data types and provides various data analysis methods.
+ * @brief A row selection stored as packed 64-bit words.
+ *
+ * Masks are produced by the Column comparison operators and can be combined with
+ * `&`, `|`, `^` and `~` before being passed to `DataFrame::operator[]`, e.g.
+ * `df[(df["Age"] > 30) & (df["Salary"] < 60000)]`. Bits past `size()` are always zero.
  */
-class DataFrame {
+class Mask {
 private:
-    map<string, Column> col_data;
-    vector<vector<string>> row_data; // used for printing
-    string file_dir;
+    vector<uint64_t> words;
+    size_t bits = 0;
+
+    void clear_tail() {
+        if (bits % 64 != 0) {
+            words.back() &= (1ULL << (bits % 64)) - 1;
+        }
+    }
+
+    void check_size(const Mask& other) const {
+        if (bits != other.bits) {
+            throw invalid_argument("Invalid argument: Mask sizes do not match");
+        }
+    }
+
 public:
-    vector<string> columns;
+    Mask() = default;
 
     /**
-     * @brief Default constructor for creating an empty DataFrame.
+     * @brief Creates a mask of `size` rows, all set to `value`.
      */
-    DataFrame() = default;
-    
+    explicit Mask(size_t size, bool value = false)
+    : words((size + 63) / 64, value ? ~0ULL : 0ULL), bits(size) {
+        clear_tail();
+    }
+
     /**
-     * @brief Copy constructor for creating a DataFrame from another DataFrame.
-     * 
-     * @param other The DataFrame to copy from
+     * @brief Packs a vector of booleans into a mask.
      */
-    DataFrame(const DataFrame& other) 
-    : col_data(other.col_data), 
-      row_data(other.row_data), 
-      file_dir(other.file_dir), 
-      columns(other.columns) {}
+    Mask(const vector<bool>& flags) : Mask(flags.size()) {
+        for (size_t i = 0; i < flags.size(); i++) {
+            if (flags[i]) {
+                set(i);
+            }
+        }
+    }
 
     /**
-     * @brief Constructor that loads data from a CSV file.
-     * 
-     * @param new_file_dir Path to the CSV file to load
-     * @throws runtime_error If the file cannot be found or opened
-     * @note Automatically detects column data types (int, float, or string)
-     * @note Handles missing values in CSV files
+     * @brief Unpacks the mask into a vector of booleans.
      */
-    DataFrame(string new_file_dir) {
-        file_dir = new_file_dir;
-        ifstream file(file_dir);
+    operator vector<bool>() const {
+        vector<bool> flags(bits);
+        for_each_set([&](size_t i) { flags[i] = true; });
+        return flags;
+    }
 
-        if (!file) {
-            throw runtime_error("Error: File not found!");
-        }
+    size_t size() const {
+        return bits;
+    }
 
-        string line;
+    bool operator[](size_t i) const {
+        return (words[i >> 6] >> (i & 63)) & 1;
+    }
 
-        vector<Column> temp_data;
+    void set(size_t i, bool value = true) {
+        uint64_t flag = 1ULL << (i & 63);
+        words[i >> 6] = value ? (words[i >> 6] | flag) : (words[i >> 6] & ~flag);
+    }
 
-        int idx = 0;
-        while(getline(file, line)) {
-            char delim = ',';
-            stringstream ss(line);
-            string element;
-            vector<string> temp_row;
+    /**
+     * @brief Sets every bit in [start, stop).
+     */
+    void set_range(size_t start, size_t stop) {
+        while (start < stop && start % 64 != 0) {
+            set(start++);
+        }
+        for (; start + 64 <= stop; start += 64) {
+            words[start >> 6] = ~0ULL;
+        }
+        while (start < stop) {
+            set(start++);
+        }
+    }
 
-            if (idx == 0) {
-                idx = 1;
-                while(getline(ss, element, delim)) {
-                    Column col;
-                    col.name = element;
-                    columns.push_back(element);
+    /**
+     * @brief Returns the number of set bits.
+     */
+    size_t count() const {
+        size_t total = 0;
+        for (uint64_t word : words) {
+            total += __builtin_popcountll(word);
+        }
+        return total;
+    }
 
-                    temp_data.push_back(col);
-                    temp_row.push_back(element);
-                }
-                row_data.push_back(temp_row);
-                continue;
+    bool any() const {
+        for (uint64_t word : words) {
+            if (word) {
+                return true;
             }
+        }
+        return false;
+    }
 
-            size_t jdx = 0;
-            while(getline(ss, element, delim)) {
-                temp_data[jdx].data.push_back(element);
-                temp_row.push_back(element);
-                jdx++;
-            }
+    bool all() const {
+        return count() == bits;
+    }
 
-            if (temp_row.size() < row_data[0].size()) {
-                // there is a missing element in that row (in the last column)
-                temp_row.push_back("");
-                temp_data[jdx].data.push_back("");
+    /**
+     * @brief Calls `fn(i)` for the index of every set bit, in increasing order.
+     */
+    template <typename Fn>
+    void for_each_set(Fn fn) const {
+        for (size_t w = 0; w < words.size(); w++) {
+            uint64_t word = words[w];
+            while (word) {
+                fn(w * 64 + __builtin_ctzll(word));
+                word &= word - 1;
             }
+        }
+    }
 
-            row_data.push_back(temp_row);
+    Mask& operator&=(const Mask& other) {
+        check_size(other);
+        for (size_t w = 0; w < words.size(); w++) {
+            words[w] &= other.words[w];
         }
+        return *this;
+    }
 
-        for (auto& col : temp_data) {
-            bool all_int = true;
-            bool all_float = true;
-            for (const string& element : col.data) {
-                if (element.length() == 0) {
-                    // missing element
-                    continue;
-                }
-                if (!is_integer(element)) {
-                    all_int = false;
-                }
-                if (!is_float(element)) {
-                    all_float = false;
-                }
-                if (!all_int && !all_float) {
-                    break;
-                }
-            }
-            if (all_int) {
-                col.dtype = "int";
-            } else if (all_float) {
-                col.dtype = "float";
-            } else {
-                col.dtype = "string";
-            }
+    Mask& operator|=(const Mask& other) {
+        check_size(other);
+        for (size_t w = 0; w < words.size(); w++) {
+            words[w] |= other.words[w];
         }
+        return *this;
+    }
 
-        for(Column col : temp_data) {
-            col_data[col.name] = col;
+    Mask& operator^=(const Mask& other) {
+        check_size(other);
+        for (size_t w = 0; w < words.size(); w++) {
+            words[w] ^= other.words[w];
         }
+        return *this;
     }
 
-    /**
-     * @brief Prints the DataFrame with various formatting options.
-     * 
-     * @param rows_cnt Number of rows to print (0 = print all rows)
-     * @param is_tail If 1, prints from the end; if 0, prints from the beginning
-     * @param cols Vector of column names to print (empty = print all columns)
+    Mask operator&(const Mask& other) const {
+        Mask result = *this;
+        return result &= other;
+    }
+
+    Mask operator|(const Mask& other) const {
+        Mask result = *this;
+        return result |= other;
+    }
+
+    Mask operator^(const Mask& other) const {
+        Mask result = *this;
+        return result ^= other;
+    }
+
+    Mask operator~() const {
+        Mask result = *this;
+        for (uint64_t& word : result.words) {
+            word = ~word;
+        }
+        result.clear_tail();
+        return result;
+    }
+
+    bool operator==(const Mask& other) const {
+        return bits == other.bits && words == other.words;
+    }
+
+    bool operator!=(const Mask& other) const {
+        return !(*this == other);
+    }
+};
+
+class Rolling;
+class DatetimeAccessor;
+
+/**
+ * @brief Represents a single column in a DataFrame with associated operations.
+ * 
+ * The Column class stores data as strings internally but can handle different data types
+ * (int, float, datetime, string) through automatic type detection and conversion. It provides
+ * statistical operations, filtering, and data manipulation methods.
+ */
+class Column {
+public:
+    string name; // column's name
+    ColumnData data; // column's data
+    string dtype = "string"; // data type
+    friend std::ostream& operator<<(std::ostream& os, const Column& col);
+
+    static const size_t ZONE_SIZE = 65536; // rows per zone map block
+
+private:
+    mutable vector<ZoneMap> zones; // per-block statistics for numeric columns
+    mutable ColumnStats col_stats; // whole-column statistics
+    mutable HyperLogLog distinct_counter; // backs col_stats.distinct
+    mutable uint64_t stats_version = numeric_limits<uint64_t>::max(); // data version the statistics describe
+    mutable string stats_dtype; // dtype the statistics were computed for
+    mutable vector<int64_t> timestamps; // datetime columns: epoch nanoseconds per row, NAT for missing
+
+    /**
+     * @brief Recomputes the statistics if the data changed since they were last computed.
+     */
+    void ensure_statistics() const {
+        if (stats_version != data.version() || stats_dtype != dtype) {
+            build_statistics();
+        }
+    }
+
+    /**
+     * @brief Updates the cached statistics after a missing cell at `idx` was filled with `element`.
+     *
+     * @note Only the distinct counter's registers are updated; the caller refreshes `col_stats.distinct` once all cells are filled
+     */
+    void account_filled(size_t idx, const string& element) const {
+        if (!is_numeric()) {
+            col_stats.null_count--;
+            col_stats.count++;
+            col_stats.sorted = false;
+            distinct_counter.add(hash<string>{}(element));
+        } else {
+            double num;
+            if (!parse_number(element, num)) {
+                return;
+            }
+            ZoneMap &zone = zones[idx / ZONE_SIZE];
+            zone.null_count--;
+            zone.min = std::min(zone.min, num);
+            zone.max = std::max(zone.max, num);
+
+            col_stats.null_count--;
+            col_stats.count++;
+            col_stats.sum += num;
+            col_stats.min = std::min(col_stats.min, num);
+            col_stats.max = std::max(col_stats.max, num);
+            col_stats.sorted = false;
+            distinct_counter.add(hash<double>{}(num));
+        }
+    }
+
+    /**
+     * @brief Extends the cached statistics, which describe the rows before `start`, over the remaining rows.
+     */
+    void accumulate_statistics(size_t start) const {
+        bool numeric = is_numeric();
+        bool datetime = dtype == "datetime";
+        ColumnStats& st = col_stats;
+
+        int64_t prev_ts = NAT;
+        for (size_t i = start; datetime && i-- > 0;) {
+            if (timestamps[i] != NAT) {
+                prev_ts = timestamps[i];
+                break;
+            }
+        }
+
+        const string* prev = nullptr;
+        for (size_t i = start; !numeric && !datetime && st.sorted && i-- > 0;) {
+            if (!data[i].empty()) {
+                prev = &data[i];
+                break;
+            }
+        }
+
+        for (size_t i = start; i < data.size(); i++) {
+            const string& element = data[i];
+            if (datetime) {
+                int64_t ns;
+                if (!parse_datetime(element, ns)) {
+                    timestamps.push_back(NAT);
+                    st.null_count++;
+                    continue;
+                }
+                timestamps.push_back(ns);
+                st.sorted = st.sorted && (prev_ts == NAT || prev_ts <= ns);
+                prev_ts = ns;
+                st.count++;
+                distinct_counter.add(hash<int64_t>{}(ns));
+                continue;
+            }
+            if (!numeric) {
+                if (element.empty()) {
+                    st.null_count++;
+                    continue;
+                }
+                st.sorted = st.sorted && (prev == nullptr || *prev <= element);
+                prev = &element;
+                st.count++;
+                distinct_counter.add(hash<string>{}(element));
+                continue;
+            }
+
+            if (i % ZONE_SIZE == 0) {
+                zones.emplace_back();
+            }
+            double num;
+            if (!parse_number(element, num)) {
+                zones.back().add_null();
+                st.null_count++;
+                continue;
+            }
+            zones.back().add(num);
+            st.sorted = st.sorted && num >= st.max;
+            st.count++;
+            st.sum += num;
+            st.min = std::min(st.min, num);
+            st.max = std::max(st.max, num);
+            distinct_counter.add(hash<double>{}(num));
+        }
+        st.distinct = distinct_counter.estimate();
+
+        stats_version = data.version();
+        stats_dtype = dtype;
+    }
+
+    /**
+     * @brief Evaluates a numeric predicate over the column, using zone maps to skip work.
+     *
+     * @param pred Row predicate applied to parsed values
+     * @param none_match Returns true if no valid value in the block can satisfy the predicate
+     * @param all_match Returns true if every valid value in the block satisfies the predicate
+     * @return Mask of matching rows, false for missing or non-numeric elements
+     * @throws runtime_error If the column dtype is not "int" or "float"
+     */
+    template <typename Pred, typename NoneMatch, typename AllMatch>
+    Mask compare_numeric(Pred pred, NoneMatch none_match, AllMatch all_match) const {
+        if (!is_numeric()) {
+           throw runtime_error("Error: Invalid comparison");
+        }
+        ensure_statistics();
+
+        Mask mask(data.size());
+        for (size_t block = 0; block < zones.size(); block++) {
+            const ZoneMap& zone = zones[block];
+            size_t start = block * ZONE_SIZE;
+            size_t stop = start + zone.rows;
+
+            if (zone.null_count == zone.rows || none_match(zone)) {
+                continue;
+            }
+            if (zone.null_count == 0 && all_match(zone)) {
+                mask.set_range(start, stop);
+                continue;
+            }
+
+            double num;
+            for (size_t i = start; i < stop; i++) {
+                if (parse_number(data[i], num) && pred(num)) {
+                    mask.set(i);
+                }
+            }
+        }
+        return mask;
+    }
+
+    /**
+     * @brief Compares a datetime column with a timestamp literal using the cached epoch nanoseconds.
+     *
+     * @param key An ISO-8601 timestamp, e.g. "2024-03-01" or "2024-03-01T12:00:00Z"
+     * @param pred Row predicate applied to (value, key) in nanoseconds
+     * @param missing Result for missing rows
+     * @throws invalid_argument If `key` is not a valid timestamp
+     */
+    template <typename Pred>
+    Mask compare_datetime(const string& key, Pred pred, bool missing = false) const {
+        int64_t key_ns;
+        if (!parse_datetime(key, key_ns)) {
+            throw invalid_argument("Invalid argument: `" + key + "` is not an ISO-8601 datetime");
+        }
+        ensure_statistics();
+
+        Mask mask(data.size());
+        for (size_t i = 0; i < timestamps.size(); i++) {
+            int64_t ns = timestamps[i];
+            if (ns == NAT ? missing : pred(ns, key_ns)) {
+                mask.set(i);
+            }
+        }
+        return mask;
+    }
+
+public:
+    /**
+     * @brief Returns true if the column dtype is "int" or "float".
+     */
+    bool is_numeric() const {
+        return dtype == "int" || dtype == "float";
+    }
+
+    /**
+     * @brief Returns the timestamps of a datetime column as nanoseconds since the Unix epoch.
+     *
+     * @return One value per row, NAT for missing values
+     * @throws invalid_argument If the column dtype is not "datetime"
+     * @note Parsed once and cached with the column statistics
+     */
+    const vector<int64_t>& datetime_values() const {
+        if (dtype != "datetime") {
+            throw invalid_argument("Invalid type: Column::datetime_values() expects `dtype` to be datetime");
+        }
+        ensure_statistics();
+        return timestamps;
+    }
+
+    /**
+     * @brief Accesses datetime operations, e.g. `df["ts"].dt().floor("1h")`.
+     *
+     * @throws invalid_argument If the column dtype is not "datetime"
+     */
+    DatetimeAccessor dt() const;
+
+    /**
+     * @brief Recomputes the cached column statistics and, for numeric columns, the per-block zone maps.
+     *
+     * @note Called at load time; stale statistics are rebuilt automatically after the data changes
+     */
+    void build_statistics() const {
+        col_stats = ColumnStats();
+        distinct_counter = HyperLogLog();
+        zones.clear();
+        timestamps.clear();
+        accumulate_statistics(0);
+    }
+
+    /**
+     * @brief Returns the cached statistics of the column, recomputing them only if the data changed.
+     *
+     * @return Count, null count, sum, min, max, sorted flag and distinct estimate of the column
+     */
+    const ColumnStats& stats() const {
+        ensure_statistics();
+        return col_stats;
+    }
+
+    /**
+     * @brief Prints the column data with optional row limiting and tail functionality.
+     * 
+     * @param rows_cnt Number of rows to print (0 = print all rows)
+     * @param is_tail If true, prints the last N rows instead of first N rows
+     */
+    void print(int rows_cnt = 0, bool is_tail = false) const {
+        if (data.size() == 0) {
+            return;
+        }
+
+        if (rows_cnt == 0) {
+            rows_cnt = data.size()-1;
+        }
+
+        cout << name << endl;
+
+        for(size_t i = 0; i < name.length(); i++) {
+            cout << '-';
+        }
+
+        cout << endl;
+
+        if (is_tail) {
+            for(size_t idx = data.size()-rows_cnt; idx < data.size(); idx++) {
+                cout << data[idx] << endl;
+            }
+        } else {
+            for(int idx = 0; idx < rows_cnt; idx++) {
+                cout << data[idx] << endl;
+            }
+        }
+
+        cout << "\nPrinted: " << rows_cnt << " rows\n";
+    }
+
+    /**
+     * @brief Displays the first N rows of the column.
+     * 
+     * @param rows_cnt Number of rows to display from the beginning (default: 5)
+     */
+    void head(int rows_cnt = 5) const {
+        print(rows_cnt);
+    }
+
+    /**
+     * @brief Displays the last N rows of the column.
+     * 
+     * @param rows_cnt Number of rows to display from the end (default: 5)
+     */
+    void tail(int rows_cnt = 5) const {
+        print(rows_cnt, true);
+    }
+
+    /**
+     * @brief Calculates the arithmetic mean of numeric column data.
+     * 
+     * @return The mean value as a double
+     * @throws invalid_argument If the column dtype is not "int" or "float"
+     * @note Empty/missing values are excluded from the calculation
+     * @note Served from the cached column statistics, so repeated calls are O(1)
+     */
+    double mean() const {
+        if (dtype == "int" || dtype == "float") {
+            const ColumnStats& st = stats();
+            return st.sum / static_cast<double>(st.count);
+        }
+
+        throw invalid_argument("Invalid type: Column::mean() expects `dtype` to be int or float");
+    }
+
+    /**
+     * @brief Calculates the sum of the column data.
+     * 
+     * @return The sum value as a double
+     * @throws invalid_argument If the column dtype is not "int" or "float"
+     * @note Empty/missing values are excluded from the calculation
+     * @note Served from the cached column statistics, so repeated calls are O(1)
+     */
+    double sum() const {
+        if (dtype == "int" || dtype == "float") {
+            return stats().sum;
+        }
+
+        throw invalid_argument("Invalid type: Column::mean() expects `dtype` to be int or float");
+    }
+    
+    /**
+     * @brief Returns a sorted copy of the column data in ascending order.
+     * 
+     * @return Vector of strings containing sorted numeric values
+     * @throws invalid_argument If the column dtype is not "int" or "float"
+     * @note The original column data remains unchanged
+     * @note The sort is skipped when the cached statistics show the column is already sorted
+     */
+    vector<string> sorted() const {
+        if (!is_numeric()) {
+            throw invalid_argument("Invalid type: Column::Sorted() expects `dtype` to be int or float");
+        }
+        vector<string> result = data;
+
+        const ColumnStats& st = stats();
+        if (st.sorted && st.null_count == 0) {
+            return result;
+        }
+
+        std::sort(result.begin(), result.end(), [](string &s1, string &s2) {
+            return stod(s1) < stod(s2);
+        });
+        
+        return result;
+    }
+
+    /**
+     * @brief Finds the minimum value in the column.
+     * 
+     * @return The minimum value as a double, or NaN if the column has no values
+     * @throws invalid_argument If the column dtype is not "int" or "float"
+     * @note Empty/missing values are ignored
+     */
+    double min() const {
+        if (!is_numeric()) {
+            throw invalid_argument("Invalid type: Column::min() expects `dtype` to be int or float");
+        }
+        const ColumnStats& st = stats();
+        return st.count == 0 ? numeric_limits<double>::quiet_NaN() : st.min;
+    }
+
+    /**
+     * @brief Finds the maximum value in the column.
+     * 
+     * @return The maximum value as a double, or NaN if the column has no values
+     * @throws invalid_argument If the column dtype is not "int" or "float"
+     * @note Empty/missing values are ignored
+     */
+    double max() const {
+        if (!is_numeric()) {
+            throw invalid_argument("Invalid type: Column::max() expects `dtype` to be int or float");
+        }
+        const ColumnStats& st = stats();
+        return st.count == 0 ? numeric_limits<double>::quiet_NaN() : st.max;
+    }
+
+    /**
+     * @brief Returns the narrowest dtype that can hold values of both dtypes (int -> float -> string, datetime -> string).
+     */
+    static string wider_dtype(const string& a, const string& b) {
+        if (a == b) {
+            return a;
+        }
+        if (a == "string" || b == "string" || a == "datetime" || b == "datetime") {
+            return "string";
+        }
+        if (a == "float" || b == "float") {
+            return "float";
+        }
+        return "int";
+    }
+
+    /**
+     * @brief Appends cells to the end of the column.
+     * 
+     * @param cells The cells to append
+     * @param cells_dtype The dtype inferred for the appended cells
+     * @note The column's dtype is widened to hold the new cells. Missing cells carry no type, so a column
+     *       with no valid cells takes `cells_dtype`, and all-missing `cells` keep the column's dtype.
+     * @note Existing cells are not reparsed: the cached statistics and zone maps are extended over the new rows
+     */
+    void append(vector<string> cells, const string& cells_dtype) {
+        size_t start = data.size();
+        string widened;
+        if (start == 0 || stats().count == 0) {
+            widened = cells_dtype;
+        } else if (std::all_of(cells.begin(), cells.end(), [](const string& cell) { return cell.empty(); })) {
+            widened = dtype;
+        } else {
+            widened = wider_dtype(dtype, cells_dtype);
+        }
+        bool stats_fresh = stats_version == data.version() && stats_dtype == dtype;
+        // statistics carry over between int and float, but not into or out of string or datetime
+        bool same_kind = widened == dtype || (is_numeric() && (widened == "int" || widened == "float"));
+
+        data.append(make_move_iterator(cells.begin()), make_move_iterator(cells.end()));
+        dtype = widened;
+
+        if (start != 0 && stats_fresh && same_kind) {
+            accumulate_statistics(start);
+        } else {
+            build_statistics();
+        }
+    }
+
+    /**
+     * @brief Parses the column into numbers.
+     * 
+     * @return One double per row, NaN for missing or non-numeric values
+     */
+    vector<double> numeric_values() const {
+        vector<double> values(data.size());
+        for (size_t i = 0; i < data.size(); i++) {
+            if (!parse_number(data[i], values[i])) {
+                values[i] = numeric_limits<double>::quiet_NaN();
+            }
+        }
+        return values;
+    }
+
+    /**
+     * @brief Builds a mergeable quantile sketch over the column's values.
+     * 
+     * @param k Accuracy parameter of the sketch (default 200, about 1.3% rank error)
+     * @return A KllSketch that can be merged with sketches of other chunks of the same data
+     * @throws invalid_argument If the column dtype is not "int" or "float"
+     * @note Blocks of rows are sketched in parallel and merged
+     */
+    KllSketch quantile_sketch(size_t k = 200) const {
+        if (!is_numeric()) {
+            throw invalid_argument("Invalid type: Column::quantile_sketch() expects `dtype` to be int or float");
+        }
+
+        size_t blocks = (data.size() + ZONE_SIZE - 1) / ZONE_SIZE;
+        vector<KllSketch> partial(blocks, KllSketch(k));
+        parallel_for(blocks, [&](size_t b) {
+            size_t stop = std::min((b + 1) * ZONE_SIZE, data.size());
+            double num;
+            for (size_t i = b * ZONE_SIZE; i < stop; i++) {
+                if (parse_number(data[i], num)) {
+                    partial[b].add(num);
+                }
+            }
+        });
+
+        KllSketch sketch(k);
+        for (const KllSketch& part : partial) {
+            sketch.merge(part);
+        }
+        return sketch;
+    }
+
+    /**
+     * @brief Returns a mergeable distinct-count sketch of the column's valid values.
+     * 
+     * @return A copy of the HyperLogLog sketch kept with the cached column statistics
+     */
+    HyperLogLog distinct_sketch() const {
+        ensure_statistics();
+        return distinct_counter;
+    }
+
+    /**
+     * @brief Computes the q-th quantile of the column.
+     * 
+     * @param q Quantile between 0 and 1 (0.5 = median)
+     * @param approximate If true, answers from a KLL sketch instead of selecting over a full copy
+     * @return The quantile (linearly interpolated when exact), or NaN if the column has no values
+     * @throws invalid_argument If the column dtype is not "int" or "float" or `q` is outside [0, 1]
+     * @note Empty/missing values are ignored
+     */
+    double quantile(double q, bool approximate = false) const {
+        if (!is_numeric()) {
+            throw invalid_argument("Invalid type: Column::quantile() expects `dtype` to be int or float");
+        }
+        if (!(q >= 0 && q <= 1)) {
+            throw invalid_argument("Invalid argument: Column::quantile() expects `q` between 0 and 1");
+        }
+        if (approximate) {
+            return quantile_sketch().quantile(q);
+        }
+
+        vector<double> values;
+        values.reserve(data.size());
+        double num;
+        for (const string& element : data) {
+            if (parse_number(element, num)) {
+                values.push_back(num);
+            }
+        }
+        if (values.empty()) {
+            return numeric_limits<double>::quiet_NaN();
+        }
+
+        double pos = q * static_cast<double>(values.size() - 1);
+        size_t lo = static_cast<size_t>(pos);
+        std::nth_element(values.begin(), values.begin() + lo, values.end());
+        double lower = values[lo];
+        if (lo + 1 == values.size()) {
+            return lower;
+        }
+        double upper = *std::min_element(values.begin() + lo + 1, values.end());
+        return lower + (upper - lower) * (pos - static_cast<double>(lo));
+    }
+
+    /**
+     * @brief Counts the distinct valid values in the column.
+     * 
+     * @param approximate If true, returns the cached HyperLogLog estimate (about 1.6% error) in O(1)
+     * @return The number of distinct values, excluding missing values
+     * @note Numeric and datetime columns compare parsed values, so "1" and "1.0" count once
+     */
+    size_t nunique(bool approximate = false) const {
+        if (approximate) {
+            return stats().distinct;
+        }
+
+        if (dtype == "datetime") {
+            ensure_statistics();
+            unordered_set<int64_t> seen(timestamps.begin(), timestamps.end());
+            return seen.size() - seen.count(NAT);
+        }
+        if (!is_numeric()) {
+            unordered_set<string_view> seen;
+            for (const string& element : data) {
+                if (!element.empty()) {
+                    seen.insert(element);
+                }
+            }
+            return seen.size();
+        }
+
+        unordered_set<double> seen;
+        double num;
+        for (const string& element : data) {
+            if (parse_number(element, num)) {
+                seen.insert(num);
+            }
+        }
+        return seen.size();
+    }
+
+    /**
+     * @brief Counts how often each value occurs in the column.
+     * 
+     * @return (value, count) pairs sorted by descending count, ties in order of first appearance
+     * @note Missing values are excluded; values are compared as stored
+     * @note Large columns are hashed and grouped in parallel, one hash partition per thread
+     */
+    vector<pair<string, size_t>> value_counts() const {
+        const vector<string>& cells = data;
+        vector<size_t> rows;
+        for (size_t i = 0; i < cells.size(); i++) {
+            if (!cells[i].empty()) {
+                rows.push_back(i);
+            }
+        }
+
+        vector<uint64_t> hashes(rows.size());
+        parallel_for((rows.size() + ZONE_SIZE - 1) / ZONE_SIZE, [&](size_t b) {
+            size_t stop = std::min((b + 1) * ZONE_SIZE, rows.size());
+            for (size_t i = b * ZONE_SIZE; i < stop; i++) {
+                hashes[i] = mix_hash(hash<string_view>{}(cells[rows[i]]));
+            }
+        });
+
+        auto groups = group_rows(hashes, [&](size_t a, size_t b) { return cells[rows[a]] == cells[rows[b]]; });
+        std::sort(groups.begin(), groups.end(), [](const pair<size_t, size_t>& a, const pair<size_t, size_t>& b) {
+            return a.second != b.second ? a.second > b.second : a.first < b.first;
+        });
+
+        vector<pair<string, size_t>> counts;
+        counts.reserve(groups.size());
+        for (const auto& group : groups) {
+            counts.push_back({cells[rows[group.first]], group.second});
+        }
+        return counts;
+    }
+
+    /**
+     * @brief Creates a sliding window over the column for moving aggregations.
+     * 
+     * @param window Number of rows in each window, including missing values
+     * @param min_periods Minimum number of valid values needed for a result (0 = `window`)
+     * @return A Rolling object providing mean(), sum(), std(), min() and max()
+     * @throws invalid_argument If the column dtype is not "int" or "float" or `window` is 0
+     */
+    Rolling rolling(size_t window, size_t min_periods = 0) const;
+
+    /**
+     * @brief Creates a growing window from the first row to each row, for cumulative aggregations.
+     * 
+     * @param min_periods Minimum number of valid values needed for a result (default: 1)
+     * @return A Rolling object providing mean(), sum(), std(), min() and max()
+     * @throws invalid_argument If the column dtype is not "int" or "float"
+     */
+    Rolling expanding(size_t min_periods = 1) const;
+
+    /**
+     * @brief Fills missing (empty) values in the column with a specified value.
+     * 
+     * @tparam T The type of the fill value (int, double, or string)
+     * @param x The value to use for filling missing entries
+     * @note For numeric types, the value is converted to string representation
+     * @note Cached statistics and zone maps are updated in place rather than rebuilt
+     */
+    template <typename T>
+    void fillna(T x) {
+        // datetime statistics are rebuilt lazily, since the fill value may not be a timestamp
+        bool stats_fresh = stats_version == data.version() && stats_dtype == dtype && dtype != "datetime";
+        data.update([&](vector<string>& cells) {
+            for (size_t idx = 0; idx < cells.size(); idx++) {
+                string &element = cells[idx];
+                if (element.length() == 0) {
+                    // missing element
+                    if constexpr (is_same<T, int>::value || is_same<T, double>::value) {
+                        if (dtype == "int") {
+                            x = static_cast<int>(x);
+                        }
+                        element = to_string(x);
+                    } else {
+                        element = x;
+                    }
+
+                    if (stats_fresh) {
+                        account_filled(idx, element);
+                    }
+                }
+            }
+        });
+        if (stats_fresh) {
+            col_stats.distinct = distinct_counter.estimate();
+            stats_version = data.version();
+        }
+    }
+
+    /**
+     * @brief Equality comparison operator for numeric columns.
+     * 
+     * @param key The numeric value to compare against
+     * @return Mask indicating which elements equal the key
+     * @throws runtime_error If the column dtype is not "int" or "float"
+     * @note Blocks whose zone map rules out or guarantees a match are resolved without reading their values
+     */
+    Mask operator==(const double& key) const {
+        return compare_numeric(
+            [&](double v) { return v == key; },
+            [&](const ZoneMap& zone) { return zone.min > key || zone.max < key; },
+            [&](const ZoneMap& zone) { return zone.min == key && zone.max == key; });
+    } 
+
+    /**
+     * @brief Inequality comparison operator for numeric columns.
+     * 
+     * @param key The numeric value to compare against
+     * @return Mask indicating which elements are not equal to the key
+     * @throws runtime_error If the column dtype is not "int" or "float"
+     * @note Blocks whose zone map rules out or guarantees a match are resolved without reading their values
+     */
+    Mask operator!=(const double& key) const {
+        return compare_numeric(
+            [&](double v) { return v != key; },
+            [&](const ZoneMap& zone) { return zone.min == key && zone.max == key; },
+            [&](const ZoneMap& zone) { return zone.min > key || zone.max < key; });
+    }
+
+    /**
+     * @brief Less-than comparison operator for numeric columns.
+     * 
+     * @param key The numeric value to compare against
+     * @return Mask indicating which elements are less than the key
+     * @throws runtime_error If the column dtype is not "int" or "float"
+     * @note Blocks whose zone map rules out or guarantees a match are resolved without reading their values
+     */
+    Mask operator<(const double& key) const {
+        return compare_numeric(
+            [&](double v) { return v < key; },
+            [&](const ZoneMap& zone) { return zone.min >= key; },
+            [&](const ZoneMap& zone) { return zone.max < key; });
+    }
+
+    /**
+     * @brief Greater-than comparison operator for numeric columns.
+     * 
+     * @param key The numeric value to compare against
+     * @return Mask indicating which elements are greater than the key
+     * @throws runtime_error If the column dtype is not "int" or "float"
+     * @note Blocks whose zone map rules out or guarantees a match are resolved without reading their values
+     */
+    Mask operator>(const double& key) const {
+        return compare_numeric(
+            [&](double v) { return v > key; },
+            [&](const ZoneMap& zone) { return zone.max <= key; },
+            [&](const ZoneMap& zone) { return zone.min > key; });
+    }
+
+    /**
+     * @brief Less-than-or-equal comparison operator for numeric columns.
+     * 
+     * @param key The numeric value to compare against
+     * @return Mask indicating which elements are less than or equal to the key
+     * @throws runtime_error If the column dtype is not "int" or "float"
+     * @note Blocks whose zone map rules out or guarantees a match are resolved without reading their values
+     */
+    Mask operator<=(const double& key) const {
+        return compare_numeric(
+            [&](double v) { return v <= key; },
+            [&](const ZoneMap& zone) { return zone.min > key; },
+            [&](const ZoneMap& zone) { return zone.max <= key; });
+    }
+
+    /**
+     * @brief Greater-than-or-equal comparison operator for numeric columns.
+     * 
+     * @param key The numeric value to compare against
+     * @return Mask indicating which elements are greater than or equal to the key
+     * @throws runtime_error If the column dtype is not "int" or "float"
+     * @note Blocks whose zone map rules out or guarantees a match are resolved without reading their values
+     */
+    Mask operator>=(const double& key) const {
+        return compare_numeric(
+            [&](double v) { return v >= key; },
+            [&](const ZoneMap& zone) { return zone.max < key; },
+            [&](const ZoneMap& zone) { return zone.min >= key; });
+    }
+
+    /**
+     * @brief Equality comparison operator for string columns.
+     * 
+     * @param key The string value to compare against
+     * @return Mask indicating which elements equal the key
+     * @throws runtime_error If the column dtype is "float" or "int"
+     * @note Datetime columns compare timestamps, parsing `key` as an ISO-8601 datetime
+     */
+    Mask operator==(const string& key) const {
+        if (is_numeric()) {
+           throw runtime_error("Error: Invalid comparison");
+        }
+        if (dtype == "datetime") {
+            return compare_datetime(key, [](int64_t v, int64_t k) { return v == k; });
+        }
+
+        Mask mask(data.size());
+        for (size_t i = 0; i < data.size(); i++) {
+            if (data[i] == key) {
+                mask.set(i);
+            }
+        }
+        return mask;
+    }
+
+    /**
+     * @brief Inequality comparison operator for string columns.
+     * 
+     * @param key The string value to compare against
+     * @return Mask indicating which elements are not equal to the key
+     * @throws runtime_error If the column dtype is "float" or "int"
+     * @note Datetime columns compare timestamps, parsing `key` as an ISO-8601 datetime
+     */
+    Mask operator!=(const string& key) const {
+        if (is_numeric()) {
+           throw runtime_error("Error: Invalid comparison");
+        }
+        if (dtype == "datetime") {
+            return compare_datetime(key, [](int64_t v, int64_t k) { return v != k; }, true);
+        }
+
+        Mask mask(data.size());
+        for (size_t i = 0; i < data.size(); i++) {
+            if (data[i] != key) {
+                mask.set(i);
+            }
+        }
+        return mask;
+    }
+
+    /**
+     * @brief Less-than comparison operator for string columns (lexicographic order).
+     * 
+     * @param key The string value to compare against
+     * @return Mask indicating which elements are lexicographically less than the key
+     * @throws runtime_error If the column dtype is "float" or "int"
+     * @note Datetime columns compare timestamps, parsing `key` as an ISO-8601 datetime
+     */
+    Mask operator<(const string& key) const {
+        if (is_numeric()) {
+           throw runtime_error("Error: Invalid comparison");
+        }
+        if (dtype == "datetime") {
+            return compare_datetime(key, [](int64_t v, int64_t k) { return v < k; });
+        }
+
+        Mask mask(data.size());
+        for (size_t i = 0; i < data.size(); i++) {
+            if (data[i] < key) {
+                mask.set(i);
+            }
+        }
+        return mask;
+    }
+
+    /**
+     * @brief Greater-than comparison operator for string columns (lexicographic order).
+     * 
+     * @param key The string value to compare against
+     * @return Mask indicating which elements are lexicographically greater than the key
+     * @throws runtime_error If the column dtype is "float" or "int"
+     * @note Datetime columns compare timestamps, parsing `key` as an ISO-8601 datetime
+     */
+    Mask operator>(const string& key) const {
+        if (is_numeric()) {
+           throw runtime_error("Error: Invalid comparison");
+        }
+        if (dtype == "datetime") {
+            return compare_datetime(key, [](int64_t v, int64_t k) { return v > k; });
+        }
+
+        Mask mask(data.size());
+        for (size_t i = 0; i < data.size(); i++) {
+            if (data[i] > key) {
+                mask.set(i);
+            }
+        }
+        return mask;
+    }
+
+    /**
+     * @brief Less-than-or-equal comparison operator for string columns (lexicographic order).
+     * 
+     * @param key The string value to compare against
+     * @return Mask indicating which elements are lexicographically less than or equal to the key
+     * @throws runtime_error If the column dtype is "float" or "int"
+     * @note Datetime columns compare timestamps, parsing `key` as an ISO-8601 datetime
+     */
+    Mask operator<=(const string& key) const {
+        if (is_numeric()) {
+           throw runtime_error("Error: Invalid comparison");
+        }
+        if (dtype == "datetime") {
+            return compare_datetime(key, [](int64_t v, int64_t k) { return v <= k; });
+        }
+
+        Mask mask(data.size());
+        for (size_t i = 0; i < data.size(); i++) {
+            if (data[i] <= key) {
+                mask.set(i);
+            }
+        }
+        return mask;
+    }
+
+    /**
+     * @brief Greater-than-or-equal comparison operator for string columns (lexicographic order).
+     * 
+     * @param key The string value to compare against
+     * @return Mask indicating which elements are lexicographically greater than or equal to the key
+     * @throws runtime_error If the column dtype is "float" or "int"
+     * @note Datetime columns compare timestamps, parsing `key` as an ISO-8601 datetime
+     */
+    Mask operator>=(const string& key) const {
+        if (is_numeric()) {
+           throw runtime_error("Error: Invalid comparison");
+        }
+        if (dtype == "datetime") {
+            return compare_datetime(key, [](int64_t v, int64_t k) { return v >= k; });
+        }
+
+        Mask mask(data.size());
+        for (size_t i = 0; i < data.size(); i++) {
+            if (data[i] >= key) {
+                mask.set(i);
+            }
+        }
+        return mask;
+    }
+};
+
+/**
+ * @brief Sliding (or expanding) window aggregations over a numeric column.
+ *
+ * Created by Column::rolling() and Column::expanding(). The column is parsed once, and each
+ * aggregation runs in a single O(n) pass regardless of the window size: running sums for
+ * sum() and mean(), Welford updates for std(), and monotonic deques for min() and max().
+ * Results are "float" columns where windows with fewer than `min_periods` valid values are missing.
+ */
+class Rolling {
+private:
+    string name;
+    vector<double> values; // NaN marks missing values
+    size_t window;         // 0 = expanding window
+    size_t min_periods;
+
+    /**
+     * @brief Slides the window over the values and formats one result per row.
+     *
+     * @param add Called with the index of each valid value entering the window
+     * @param remove Called with the index of each valid value leaving the window
+     * @param value Computes the aggregate from the number of valid values in the window
+     */
+    template <typename Add, typename Remove, typename Value>
+    Column slide(Add add, Remove remove, Value value) const {
+        Column result;
+        result.name = name;
+        result.dtype = "float";
+
+        vector<string> out(values.size());
+        size_t valid = 0;
+        for (size_t i = 0; i < values.size(); i++) {
+            if (values[i] == values[i]) {
+                add(i);
+                valid++;
+            }
+            if (window != 0 && i >= window && values[i - window] == values[i - window]) {
+                remove(i - window);
+                valid--;
+            }
+            if (valid > 0 && valid >= min_periods) {
+                out[i] = format_number(value(valid));
+            }
+        }
+        result.data = std::move(out);
+        return result;
+    }
+
+public:
+    Rolling(string col_name, vector<double> col_values, size_t window_size, size_t required)
+    : name(std::move(col_name)), values(std::move(col_values)), window(window_size), min_periods(required) {}
+
+    /**
+     * @brief Sum of the valid values in each window.
+     */
+    Column sum() const {
+        double total = 0;
+        return slide(
+            [&](size_t i) { total += values[i]; },
+            [&](size_t i) { total -= values[i]; },
+            [&](size_t) { return total; });
+    }
+
+    /**
+     * @brief Mean of the valid values in each window.
+     */
+    Column mean() const {
+        double total = 0;
+        return slide(
+            [&](size_t i) { total += values[i]; },
+            [&](size_t i) { total -= values[i]; },
+            [&](size_t valid) { return total / static_cast<double>(valid); });
+    }
+
+    /**
+     * @brief Sample standard deviation (ddof = 1) of the valid values in each window.
+     *
+     * @note Windows with fewer than two valid values are missing
+     */
+    Column std() const {
+        double avg = 0;
+        double m2 = 0;
+        size_t n = 0;
+        return slide(
+            [&](size_t i) {
+                n++;
+                double delta = values[i] - avg;
+                avg += delta / static_cast<double>(n);
+                m2 += delta * (values[i] - avg);
+            },
+            [&](size_t i) {
+                n--;
+                if (n == 0) {
+                    avg = 0;
+                    m2 = 0;
+                    return;
+                }
+                double delta = values[i] - avg;
+                avg -= delta / static_cast<double>(n);
+                m2 -= delta * (values[i] - avg);
+            },
+            [&](size_t valid) {
+                if (valid < 2) {
+                    return numeric_limits<double>::quiet_NaN();
+                }
+                return sqrt(std::max(m2, 0.0) / static_cast<double>(valid - 1));
+            });
+    }
+
+    /**
+     * @brief Minimum of the valid values in each window.
+     */
+    Column min() const {
+        return extreme([](double a, double b) { return a <= b; });
+    }
+
+    /**
+     * @brief Maximum of the valid values in each window.
+     */
+    Column max() const {
+        return extreme([](double a, double b) { return a >= b; });
+    }
+
+private:
+    /**
+     * @brief Tracks the window extreme with a monotonic deque of row indices.
+     *
+     * @param keeps Returns true if a value `a` that entered earlier should be kept ahead of a newer `b`
+     */
+    template <typename Keeps>
+    Column extreme(Keeps keeps) const {
+        deque<size_t> candidates;
+        return slide(
+            [&](size_t i) {
+                while (!candidates.empty() && !keeps(values[candidates.back()], values[i])) {
+                    candidates.pop_back();
+                }
+                candidates.push_back(i);
+            },
+            [&](size_t i) {
+                if (!candidates.empty() && candidates.front() == i) {
+                    candidates.pop_front();
+                }
+            },
+            [&](size_t) { return values[candidates.front()]; });
+    }
+};
+
+Rolling Column::rolling(size_t window, size_t min_periods) const {
+    if (!is_numeric()) {
+        throw invalid_argument("Invalid type: Column::rolling() expects `dtype` to be int or float");
+    }
+    if (window == 0) {
+        throw invalid_argument("Invalid argument: Column::rolling() expects `window` to be positive");
+    }
+    return Rolling(name, numeric_values(), window, min_periods == 0 ? window : min_periods);
+}
+
+Rolling Column::expanding(size_t min_periods) const {
+    if (!is_numeric()) {
+        throw invalid_argument("Invalid type: Column::expanding() expects `dtype` to be int or float");
+    }
+    return Rolling(name, numeric_values(), 0, min_periods);
+}
+
+/**
+ * @brief Datetime operations on a column, returned by Column::dt().
+ */
+class DatetimeAccessor {
+private:
+    const Column& col;
+
+    /**
+     * @brief Builds a datetime column from epoch nanoseconds.
+     */
+    Column from_timestamps(const vector<int64_t>& values) const {
+        Column result;
+        result.name = col.name;
+        result.dtype = "datetime";
+        vector<string> cells(values.size());
+        for (size_t i = 0; i < values.size(); i++) {
+            cells[i] = format_datetime(values[i]);
+        }
+        result.data = std::move(cells);
+        result.build_statistics();
+        return result;
+    }
+
+public:
+    explicit DatetimeAccessor(const Column& source) : col(source) {}
+
+    /**
+     * @brief Rounds each timestamp down to a multiple of `freq` since the epoch, e.g. to the start of its hour.
+     * 
+     * @param freq The bucket width, e.g. "1h", "15min", "1d"
+     * @return A datetime column of bucket starts, usable with value_counts(), drop_duplicates() or as a key
+     * @throws invalid_argument If `freq` is not a valid frequency
+     */
+    Column floor(const string& freq) const {
+        int64_t step = parse_frequency(freq);
+        vector<int64_t> values = col.datetime_values();
+        for (int64_t& ns : values) {
+            if (ns != NAT) {
+                int64_t rem = ns % step;
+                ns -= rem < 0 ? rem + step : rem;
+            }
+        }
+        return from_timestamps(values);
+    }
+
+    /**
+     * @brief Rounds each timestamp up to a multiple of `freq` since the epoch.
+     * 
+     * @param freq The bucket width, e.g. "1h", "15min", "1d"
+     * @throws invalid_argument If `freq` is not a valid frequency
+     */
+    Column ceil(const string& freq) const {
+        int64_t step = parse_frequency(freq);
+        vector<int64_t> values = col.datetime_values();
+        for (int64_t& ns : values) {
+            if (ns != NAT) {
+                int64_t rem = ns % step;
+                ns += rem > 0 ? step - rem : (rem < 0 ? -rem : 0);
+            }
+        }
+        return from_timestamps(values);
+    }
+};
+
+DatetimeAccessor Column::dt() const {
+    if (dtype != "datetime") {
+        throw invalid_argument("Invalid type: Column::dt() expects `dtype` to be datetime");
+    }
+    return DatetimeAccessor(*this);
+}
+
+/**
+ * @brief Base class of column arithmetic expressions (expression templates).
+ *
+ * Expressions such as `df["price"] * df["qty"] - df["discount"]` build a tree of small nodes
+ * instead of computing intermediate columns. evaluate() walks the rows once in blocks of
+ * EXPR_BLOCK values: leaves parse their cells into a stack buffer, and each operator combines
+ * whole blocks in tight loops the compiler can vectorize. Missing values are NaN inside the
+ * evaluator, so they propagate through every operator and come out as missing cells.
+ *
+ * @note Expressions refer to their columns, which must outlive them
+ */
+template <typename Derived>
+class Expr {
+public:
+    static constexpr size_t EXPR_BLOCK = 1024;
+    static constexpr size_t BROADCAST = numeric_limits<size_t>::max(); // size of a scalar
+
+    const Derived& self() const {
+        return static_cast<const Derived&>(*this);
+    }
+
+    /**
+     * @brief Evaluates the expression into a new column.
+     * 
+     * @param name The name of the resulting column
+     * @return An "int" column if every result is a whole number (that fits an int), a "float" column otherwise
+     * @throws invalid_argument If the expression contains no column
+     * @note Row ranges are evaluated in parallel
+     */
+    Column evaluate(const string& name = "") const {
+        const Derived& expr = self();
+        size_t rows = expr.size();
+        if (rows == BROADCAST) {
+            throw invalid_argument("Invalid argument: expression does not contain a column");
+        }
+
+        vector<string> cells(rows);
+        size_t chunks = (rows + Column::ZONE_SIZE - 1) / Column::ZONE_SIZE;
+        vector<char> integral(chunks, 1);
+        parallel_for(chunks, [&](size_t c) {
+            double values[EXPR_BLOCK];
+            size_t stop = std::min((c + 1) * Column::ZONE_SIZE, rows);
+            for (size_t start = c * Column::ZONE_SIZE; start < stop; start += EXPR_BLOCK) {
+                size_t len = std::min(EXPR_BLOCK, stop - start);
+                expr.eval_block(start, len, values);
+                for (size_t k = 0; k < len; k++) {
+                    double num = values[k];
+                    cells[start + k] = format_number(num);
+                    if (num == num && (num != trunc(num) || fabs(num) >= 2147483648.0)) {
+                        integral[c] = 0;
+                    }
+                }
+            }
+        });
+
+        Column col;
+        col.name = name;
+        col.dtype = std::find(integral.begin(), integral.end(), 0) == integral.end() ? "int" : "float";
+        col.data = std::move(cells);
+        col.build_statistics();
+        return col;
+    }
+};
+
+/**
+ * @brief Expression leaf reading a numeric column.
+ */
+class ColumnRef : public Expr<ColumnRef> {
+private:
+    const Column* col;
+
+public:
+    /**
+     * @throws invalid_argument If the column dtype is not "int" or "float"
+     */
+    explicit ColumnRef(const Column& source) : col(&source) {
+        if (!source.is_numeric()) {
+            throw invalid_argument("Invalid type: column arithmetic expects `dtype` to be int or float");
+        }
+    }
+
+    size_t size() const {
+        return col->data.size();
+    }
+
+    void eval_block(size_t start, size_t len, double* out) const {
+        for (size_t k = 0; k < len; k++) {
+            if (!parse_number(col->data[start + k], out[k])) {
+                out[k] = numeric_limits<double>::quiet_NaN();
+            }
+        }
+    }
+};
+
+/**
+ * @brief Expression leaf holding a constant.
+ */
+class Scalar : public Expr<Scalar> {
+private:
+    double value;
+
+public:
+    explicit Scalar(double value) : value(value) {}
+
+    size_t size() const {
+        return BROADCAST;
+    }
+
+    void eval_block(size_t, size_t len, double* out) const {
+        std::fill(out, out + len, value);
+    }
+};
+
+/**
+ * @brief Returns the row count shared by two operands, or throws if they differ.
+ */
+size_t combined_size(size_t a, size_t b) {
+    if (a == Scalar::BROADCAST) {
+        return b;
+    }
+    if (b != Scalar::BROADCAST && a != b) {
+        throw invalid_argument("Invalid argument: column lengths do not match");
+    }
+    return a;
+}
+
+struct AddOp { static double apply(double a, double b) { return a + b; } };
+struct SubOp { static double apply(double a, double b) { return a - b; } };
+struct MulOp { static double apply(double a, double b) { return a * b; } };
+struct DivOp { static double apply(double a, double b) { return a / b; } };
+struct NegOp { double apply(double a) const { return -a; } };
+struct AbsOp { double apply(double a) const { return fabs(a); } };
+struct LogOp { double apply(double a) const { return log(a); } };
+struct ClipOp {
+    double lower;
+    double upper;
+    // written so that NaN (missing) passes through unchanged
+    double apply(double a) const { return a < lower ? lower : (a > upper ? upper : a); }
+};
+
+/**
+ * @brief Expression node applying a binary operator to two sub-expressions.
+ */
+template <typename Op, typename L, typename R>
+class BinaryExpr : public Expr<BinaryExpr<Op, L, R>> {
+private:
+    L left;
+    R right;
+    size_t rows;
+
+public:
+    BinaryExpr(L lhs, R rhs) : left(std::move(lhs)), right(std::move(rhs)), rows(combined_size(left.size(), right.size())) {}
+
+    size_t size() const {
+        return rows;
+    }
+
+    void eval_block(size_t start, size_t len, double* out) const {
+        double rhs[Expr<BinaryExpr>::EXPR_BLOCK];
+        left.eval_block(start, len, out);
+        right.eval_block(start, len, rhs);
+        for (size_t k = 0; k < len; k++) {
+            out[k] = Op::apply(out[k], rhs[k]);
+        }
+    }
+};
+
+/**
+ * @brief Expression node applying a unary function to a sub-expression.
+ */
+template <typename Op, typename E>
+class UnaryExpr : public Expr<UnaryExpr<Op, E>> {
+private:
+    Op op;
+    E inner;
+
+public:
+    UnaryExpr(Op fn, E arg) : op(fn), inner(std::move(arg)) {}
+
+    size_t size() const {
+        return inner.size();
+    }
+
+    void eval_block(size_t start, size_t len, double* out) const {
+        inner.eval_block(start, len, out);
+        for (size_t k = 0; k < len; k++) {
+            out[k] = op.apply(out[k]);
+        }
+    }
+};
+
+/**
+ * @brief Expression node choosing, row by row, between two sub-expressions.
+ */
+template <typename A, typename B>
+class WhereExpr : public Expr<WhereExpr<A, B>> {
+private:
+    Mask cond;
+    A when_true;
+    B when_false;
+    size_t rows;
+
+public:
+    WhereExpr(Mask mask, A a, B b)
+    : cond(std::move(mask)), when_true(std::move(a)), when_false(std::move(b)),
+      rows(combined_size(combined_size(cond.size(), when_true.size()), when_false.size())) {}
+
+    size_t size() const {
+        return rows;
+    }
+
+    void eval_block(size_t start, size_t len, double* out) const {
+        double other[Expr<WhereExpr>::EXPR_BLOCK];
+        when_true.eval_block(start, len, out);
+        when_false.eval_block(start, len, other);
+        for (size_t k = 0; k < len; k++) {
+            out[k] = cond[start + k] ? out[k] : other[k];
+        }
+    }
+};
+
+ColumnRef as_expr(const Column& col) {
+    return ColumnRef(col);
+}
+
+Scalar as_expr(double value) {
+    return Scalar(value);
+}
+
+template <typename Derived>
+const Derived& as_expr(const Expr<Derived>& expr) {
+    return expr.self();
+}
+
+template <typename T>
+constexpr bool is_expr_term_v = is_same_v<T, Column> || is_base_of_v<Expr<T>, T>;
+
+template <typename T>
+constexpr bool is_expr_operand_v = is_expr_term_v<decay_t<T>> || is_arithmetic_v<decay_t<T>>;
+
+// enabled when both operands are columns, expressions or numbers, and at least one is not a number
+template <typename L, typename R>
+using enable_if_expr_t = enable_if_t<is_expr_operand_v<L> && is_expr_operand_v<R>
+                                     && (is_expr_term_v<decay_t<L>> || is_expr_term_v<decay_t<R>>)>;
+
+template <typename T>
+using expr_t = decay_t<decltype(as_expr(declval<const T&>()))>;
+
+template <typename L, typename R, typename = enable_if_expr_t<L, R>>
+BinaryExpr<AddOp, expr_t<L>, expr_t<R>> operator+(const L& lhs, const R& rhs) {
+    return {as_expr(lhs), as_expr(rhs)};
+}
+
+template <typename L, typename R, typename = enable_if_expr_t<L, R>>
+BinaryExpr<SubOp, expr_t<L>, expr_t<R>> operator-(const L& lhs, const R& rhs) {
+    return {as_expr(lhs), as_expr(rhs)};
+}
+
+template <typename L, typename R, typename = enable_if_expr_t<L, R>>
+BinaryExpr<MulOp, expr_t<L>, expr_t<R>> operator*(const L& lhs, const R& rhs) {
+    return {as_expr(lhs), as_expr(rhs)};
+}
+
+template <typename L, typename R, typename = enable_if_expr_t<L, R>>
+BinaryExpr<DivOp, expr_t<L>, expr_t<R>> operator/(const L& lhs, const R& rhs) {
+    return {as_expr(lhs), as_expr(rhs)};
+}
+
+template <typename E, typename = enable_if_t<is_expr_term_v<E>>>
+UnaryExpr<NegOp, expr_t<E>> operator-(const E& arg) {
+    return {NegOp(), as_expr(arg)};
+}
+
+/**
+ * @brief Absolute value of a column or expression.
+ */
+template <typename E, typename = enable_if_t<is_expr_term_v<E>>>
+UnaryExpr<AbsOp, expr_t<E>> abs(const E& arg) {
+    return {AbsOp(), as_expr(arg)};
+}
+
+/**
+ * @brief Natural logarithm of a column or expression; non-positive values give -inf or missing.
+ */
+template <typename E, typename = enable_if_t<is_expr_term_v<E>>>
+UnaryExpr<LogOp, expr_t<E>> log(const E& arg) {
+    return {LogOp(), as_expr(arg)};
+}
+
+/**
+ * @brief Limits the values of a column or expression to [lower, upper].
+ */
+template <typename E, typename = enable_if_t<is_expr_term_v<E>>>
+UnaryExpr<ClipOp, expr_t<E>> clip(const E& arg, double lower, double upper) {
+    return {ClipOp{lower, upper}, as_expr(arg)};
+}
+
+/**
+ * @brief Takes `a` where `cond` is set and `b` elsewhere, row by row.
+ * 
+ * @param cond The row mask, e.g. `df["qty"] > 0`
+ * @param a Column, expression or number used where the mask is set
+ * @param b Column, expression or number used elsewhere
+ */
+template <typename A, typename B, typename = enable_if_t<is_expr_operand_v<A> && is_expr_operand_v<B>>>
+WhereExpr<expr_t<A>, expr_t<B>> where(const Mask& cond, const A& a, const B& b) {
+    return {cond, as_expr(a), as_expr(b)};
+}
+
+/**
+ * @brief Checks if a string represents a valid integer.
+ * 
+ * @param s The string to test
+ * @return True if the string can be converted to an integer, false otherwise
+ */
+bool is_integer(const string& s) {
+    int value;
+    return parse_integer(s, value);
+}
+
+/**
+ * @brief Checks if a string represents a valid floating-point number.
+ * 
+ * @param s The string to test
+ * @return True if the string can be converted to a double, false otherwise
+ */
+bool is_float(const string& s) {
+    try {
+        size_t pos;
+        stod(s, &pos);
+        return pos == s.length();
+    } catch (...) {
+        return false;
+    }
+}
+
+/**
+ * @brief Infers the dtype of a set of cells.
+ * 
+ * @param cells The cells to inspect; empty (missing) cells are ignored
+ * @return "int" if every cell is an integer, "float" if every cell is a number,
+ *         "datetime" if every cell is an ISO-8601 timestamp, "string" otherwise
+ */
+string infer_dtype(const vector<string>& cells) {
+    bool all_int = true;
+    bool all_float = true;
+    bool all_datetime = true;
+    int64_t ns;
+    for (const string& element : cells) {
+        if (element.length() == 0) {
+            // missing element
+            continue;
+        }
+        if (all_datetime && !parse_datetime(element, ns)) {
+            all_datetime = false;
+        }
+        if (all_int && !is_integer(element)) {
+            all_int = false;
+        }
+        if (all_float && !is_float(element)) {
+            all_float = false;
+        }
+        if (!all_int && !all_float && !all_datetime) {
+            break;
+        }
+    }
+    if (all_int) {
+        return "int";
+    } else if (all_float) {
+        return "float";
+    } else if (all_datetime) {
+        return "datetime";
+    }
+    return "string";
+}
+
+/**
+ * @brief Options controlling how a CSV file is read.
+ */
+struct CsvOptions {
+    vector<string> usecols; // columns to load (empty = all); other fields are skipped while tokenizing
+    size_t nrows = 0;       // maximum number of data rows to read (0 = all)
+    size_t skiprows = 0;    // lines to skip at the start of the file, before the header
+    char delimiter = ',';   // field delimiter
+    char quotechar = '"';   // quote character ('\0' disables quoting)
+};
+
+/**
+ * @brief Splits a CSV record into fields, copying only the selected ones.
+ * 
+ * A field that starts with `quote` may contain delimiters, newlines and doubled quotes.
+ * A trailing empty field after the last delimiter is not counted.
+ * 
+ * @param record The record to split
+ * @param delim The field delimiter
+ * @param quote The quote character ('\0' disables quoting)
+ * @param selected Per-field flags; unselected fields and fields past its end are skipped without copying (empty = keep all)
+ * @param fields Receives the selected fields, in file order
+ * @param field_count Receives the number of fields in the record
+ * @return False if the record ends inside a quoted field
+ */
+bool tokenize_record(const string& record, char delim, char quote, const vector<char>& selected,
+                     vector<string>& fields, size_t& field_count) {
+    fields.clear();
+    field_count = 0;
+    size_t pos = 0;
+    size_t len = record.size();
+
+    while (pos < len) {
+        bool keep = selected.empty() || (field_count < selected.size() && selected[field_count]);
+        field_count++;
+
+        if (quote != '\0' && record[pos] == quote) {
+            string value;
+            pos++;
+            while (true) {
+                if (pos >= len) {
+                    if (keep) {
+                        fields.push_back(std::move(value));
+                    }
+                    return false;
+                }
+                if (record[pos] == quote) {
+                    if (pos + 1 < len && record[pos + 1] == quote) {
+                        if (keep) {
+                            value += quote;
+                        }
+                        pos += 2;
+                        continue;
+                    }
+                    pos++;
+                    break;
+                }
+                if (keep) {
+                    value += record[pos];
+                }
+                pos++;
+            }
+            // anything between the closing quote and the delimiter is kept as is
+            size_t stop = record.find(delim, pos);
+            if (stop == string::npos) {
+                stop = len;
+            }
+            if (keep) {
+                value.append(record, pos, stop - pos);
+                fields.push_back(std::move(value));
+            }
+            pos = stop + 1;
+            continue;
+        }
+
+        size_t stop = record.find(delim, pos);
+        if (stop == string::npos) {
+            stop = len;
+        }
+        if (keep) {
+            fields.emplace_back(record, pos, stop - pos);
+        }
+        pos = stop + 1;
+    }
+    return true;
+}
+
+/**
+ * @brief Writes one CSV field, quoting it when it contains the separator, a quote or a line break.
+ * 
+ * Quotes inside a quoted field are doubled, so tokenize_record() reads the value back unchanged.
+ * 
+ * @param out The stream to write to
+ * @param value The field value
+ * @param sep The field separator
+ * @param quote The quote character
+ */
+void write_csv_field(ostream& out, const string& value, const string& sep, char quote = '"') {
+    bool needs_quotes = value.find(quote) != string::npos || value.find_first_of("\r\n") != string::npos
+                        || (!sep.empty() && value.find(sep) != string::npos);
+    if (!needs_quotes) {
+        out << value;
+        return;
+    }
+    out << quote;
+    for (char c : value) {
+        if (c == quote) {
+            out << quote;
+        }
+        out << c;
+    }
+    out << quote;
+}
+
+/**
+ * @brief Detects the compression of a file from its magic bytes.
+ * 
+ * @param path Path to the file
+ * @return "gzip", "zstd" or "none"
+ */
+string detect_compression(const string& path) {
+    ifstream file(path, ios::binary);
+    unsigned char magic[4] = {0, 0, 0, 0};
+    file.read(reinterpret_cast<char*>(magic), sizeof(magic));
+    size_t got = file.gcount();
+    if (got >= 2 && magic[0] == 0x1f && magic[1] == 0x8b) {
+        return "gzip";
+    }
+    if (got == 4 && magic[0] == 0x28 && magic[1] == 0xb5 && magic[2] == 0x2f && magic[3] == 0xfd) {
+        return "zstd";
+    }
+    return "none";
+}
+
+/**
+ * @brief Chooses the compression of an output file from its extension (".gz" or ".zst").
+ */
+string compression_from_extension(const string& path) {
+    string ext = std::filesystem::path(path).extension().string();
+    if (ext == ".gz") {
+        return "gzip";
+    }
+    if (ext == ".zst") {
+        return "zstd";
+    }
+    return "none";
+}
+
+/**
+ * @brief Produces the decompressed bytes of a file, one block at a time.
+ */
+class BlockDecoder {
+public:
+    virtual ~BlockDecoder() = default;
+
+    /**
+     * @brief Decompresses up to `capacity` bytes into `out`.
+     * 
+     * @return The number of bytes produced, 0 at the end of the input
+     * @throws runtime_error If the input is corrupt or truncated
+     */
+    virtual size_t read(char* out, size_t capacity) = 0;
+};
+
+/**
+ * @brief Consumes bytes to be compressed and writes the compressed stream to `out`.
+ */
+class BlockEncoder {
+public:
+    virtual ~BlockEncoder() = default;
+    virtual void write(const char* data, size_t size) = 0;
+
+    /**
+     * @brief Flushes the remaining compressed data and ends the stream.
+     */
+    virtual void finish() = 0;
+};
+
+#ifdef LESSER_PANDAS_WITH_ZLIB
+/**
+ * @brief gzip decoder; concatenated gzip members are decoded one after another.
+ */
+class GzipDecoder : public BlockDecoder {
+private:
+    ifstream file;
+    z_stream zs{};
+    vector<char> input = vector<char>(1 << 16);
+    bool in_member = false;
+
+public:
+    explicit GzipDecoder(const string& path) : file(path, ios::binary) {
+        if (!file) {
+            throw runtime_error("Error: File not found!");
+        }
+        if (inflateInit2(&zs, 15 + 32) != Z_OK) {
+            throw runtime_error("Error: Unable to initialize gzip decoder!");
+        }
+    }
+
+    ~GzipDecoder() override {
+        inflateEnd(&zs);
+    }
+
+    size_t read(char* out, size_t capacity) override {
+        zs.next_out = reinterpret_cast<Bytef*>(out);
+        zs.avail_out = static_cast<uInt>(capacity);
+        while (zs.avail_out > 0) {
+            if (zs.avail_in == 0) {
+                file.read(input.data(), input.size());
+                zs.next_in = reinterpret_cast<Bytef*>(input.data());
+                zs.avail_in = static_cast<uInt>(file.gcount());
+                if (zs.avail_in == 0) {
+                    if (in_member) {
+                        throw runtime_error("Error: Truncated gzip data!");
+                    }
+                    break;
+                }
+            }
+            in_member = true;
+            int ret = inflate(&zs, Z_NO_FLUSH);
+            if (ret == Z_STREAM_END) {
+                in_member = false;
+                inflateReset(&zs);
+            } else if (ret != Z_OK && ret != Z_BUF_ERROR) {
+                throw runtime_error("Error: Corrupt gzip data!");
+            }
+        }
+        return capacity - zs.avail_out;
+    }
+};
+
+/**
+ * @brief gzip encoder.
+ */
+class GzipEncoder : public BlockEncoder {
+private:
+    ostream& out;
+    z_stream zs{};
+    vector<char> output = vector<char>(1 << 16);
+
+    void pump(int flush) {
+        int ret;
+        do {
+            zs.next_out = reinterpret_cast<Bytef*>(output.data());
+            zs.avail_out = static_cast<uInt>(output.size());
+            ret = deflate(&zs, flush);
+            out.write(output.data(), output.size() - zs.avail_out);
+        } while (zs.avail_out == 0 || (flush == Z_FINISH && ret != Z_STREAM_END));
+    }
+
+public:
+    explicit GzipEncoder(ostream& out) : out(out) {
+        if (deflateInit2(&zs, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+            throw runtime_error("Error: Unable to initialize gzip encoder!");
+        }
+    }
+
+    ~GzipEncoder() override {
+        deflateEnd(&zs);
+    }
+
+    void write(const char* data, size_t size) override {
+        zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+        zs.avail_in = static_cast<uInt>(size);
+        pump(Z_NO_FLUSH);
+    }
+
+    void finish() override {
+        zs.next_in = nullptr;
+        zs.avail_in = 0;
+        pump(Z_FINISH);
+    }
+};
+#endif
+
+#ifdef LESSER_PANDAS_WITH_ZSTD
+/**
+ * @brief zstd decoder; concatenated frames are decoded one after another.
+ */
+class ZstdDecoder : public BlockDecoder {
+private:
+    ifstream file;
+    ZSTD_DCtx* ctx;
+    vector<char> input = vector<char>(ZSTD_DStreamInSize());
+    ZSTD_inBuffer in_buf{nullptr, 0, 0};
+    size_t pending = 0; // non-zero while a frame is incomplete
+
+public:
+    explicit ZstdDecoder(const string& path) : file(path, ios::binary), ctx(ZSTD_createDCtx()) {
+        if (!ctx) {
+            throw runtime_error("Error: Unable to initialize zstd decoder!");
+        }
+        if (!file) {
+            ZSTD_freeDCtx(ctx);
+            throw runtime_error("Error: File not found!");
+        }
+    }
+
+    ~ZstdDecoder() override {
+        ZSTD_freeDCtx(ctx);
+    }
+
+    size_t read(char* out, size_t capacity) override {
+        ZSTD_outBuffer out_buf{out, capacity, 0};
+        while (out_buf.pos < out_buf.size) {
+            if (in_buf.pos == in_buf.size) {
+                file.read(input.data(), input.size());
+                in_buf = ZSTD_inBuffer{input.data(), static_cast<size_t>(file.gcount()), 0};
+            }
+            // at the end of the file, a frame may still have decoded output to flush
+            bool at_end = in_buf.size == 0;
+            if (at_end && pending == 0) {
+                break;
+            }
+            size_t before = out_buf.pos;
+            pending = ZSTD_decompressStream(ctx, &out_buf, &in_buf);
+            if (ZSTD_isError(pending)) {
+                throw runtime_error("Error: Corrupt zstd data!");
+            }
+            if (at_end && pending != 0 && out_buf.pos == before) {
+                throw runtime_error("Error: Truncated zstd data!");
+            }
+        }
+        return out_buf.pos;
+    }
+};
+
+/**
+ * @brief zstd encoder.
+ */
+class ZstdEncoder : public BlockEncoder {
+private:
+    ostream& out;
+    ZSTD_CCtx* ctx;
+    vector<char> output = vector<char>(ZSTD_CStreamOutSize());
+
+    void pump(ZSTD_inBuffer& in_buf, ZSTD_EndDirective mode) {
+        size_t remaining;
+        do {
+            ZSTD_outBuffer out_buf{output.data(), output.size(), 0};
+            remaining = ZSTD_compressStream2(ctx, &out_buf, &in_buf, mode);
+            if (ZSTD_isError(remaining)) {
+                throw runtime_error("Error: zstd compression failed!");
+            }
+            out.write(output.data(), out_buf.pos);
+        } while (mode == ZSTD_e_end ? remaining != 0 : in_buf.pos < in_buf.size);
+    }
+
+public:
+    explicit ZstdEncoder(ostream& out) : out(out), ctx(ZSTD_createCCtx()) {
+        if (!ctx) {
+            throw runtime_error("Error: Unable to initialize zstd encoder!");
+        }
+    }
+
+    ~ZstdEncoder() override {
+        ZSTD_freeCCtx(ctx);
+    }
+
+    void write(const char* data, size_t size) override {
+        ZSTD_inBuffer in_buf{data, size, 0};
+        pump(in_buf, ZSTD_e_continue);
+    }
+
+    void finish() override {
+        ZSTD_inBuffer in_buf{nullptr, 0, 0};
+        pump(in_buf, ZSTD_e_end);
+    }
+};
+#endif
+
+/**
+ * @brief Creates a decoder for a compressed file.
+ * 
+ * @throws runtime_error If support for the compression was not compiled in
+ */
+unique_ptr<BlockDecoder> make_decoder(const string& compression, const string& path) {
+#ifdef LESSER_PANDAS_WITH_ZLIB
+    if (compression == "gzip") {
+        return make_unique<GzipDecoder>(path);
+    }
+#endif
+#ifdef LESSER_PANDAS_WITH_ZSTD
+    if (compression == "zstd") {
+        return make_unique<ZstdDecoder>(path);
+    }
+#endif
+    (void) path;
+    throw runtime_error("Error: " + compression + " support is not enabled (define LESSER_PANDAS_WITH_"
+                        + string(compression == "gzip" ? "ZLIB" : "ZSTD") + ")!");
+}
+
+/**
+ * @brief Creates an encoder writing a compressed stream to `out`.
+ * 
+ * @throws runtime_error If support for the compression was not compiled in
+ */
+unique_ptr<BlockEncoder> make_encoder(const string& compression, ostream& out) {
+#ifdef LESSER_PANDAS_WITH_ZLIB
+    if (compression == "gzip") {
+        return make_unique<GzipEncoder>(out);
+    }
+#endif
+#ifdef LESSER_PANDAS_WITH_ZSTD
+    if (compression == "zstd") {
+        return make_unique<ZstdEncoder>(out);
+    }
+#endif
+    (void) out;
+    throw runtime_error("Error: " + compression + " support is not enabled (define LESSER_PANDAS_WITH_"
+                        + string(compression == "gzip" ? "ZLIB" : "ZSTD") + ")!");
+}
+
+/**
+ * @brief Input stream buffer fed by a background decompression thread.
+ *
+ * The worker thread decompresses into a ring of fixed-size buffers while the reader parses
+ * the previous ones, so decompression overlaps with tokenizing. Errors raised by the decoder
+ * are rethrown to the reader.
+ */
+class PipelinedReadBuf : public streambuf {
+private:
+    static const size_t BUFFER_SIZE = 1 << 20;
+    static const size_t BUFFER_COUNT = 4;
+    static const size_t NONE = numeric_limits<size_t>::max();
+
+    unique_ptr<BlockDecoder> decoder;
+    vector<vector<char>> buffers;
+    deque<size_t> free_slots;
+    deque<pair<size_t, size_t>> filled; // (slot, bytes)
+    size_t current = NONE;              // slot being read
+    bool done = false;
+    bool stop = false;
+    exception_ptr error;
+    mutex lock;
+    condition_variable changed;
+    thread worker;
+
+    void produce() {
+        try {
+            while (true) {
+                size_t slot;
+                {
+                    unique_lock<mutex> guard(lock);
+                    changed.wait(guard, [&]() { return stop || !free_slots.empty(); });
+                    if (stop) {
+                        return;
+                    }
+                    slot = free_slots.front();
+                    free_slots.pop_front();
+                }
+
+                size_t bytes = decoder->read(buffers[slot].data(), BUFFER_SIZE);
+
+                lock_guard<mutex> guard(lock);
+                if (bytes == 0) {
+                    done = true;
+                    changed.notify_all();
+                    return;
+                }
+                filled.push_back({slot, bytes});
+                changed.notify_all();
+            }
+        } catch (...) {
+            lock_guard<mutex> guard(lock);
+            error = current_exception();
+            done = true;
+            changed.notify_all();
+        }
+    }
+
+protected:
+    int_type underflow() override {
+        if (gptr() < egptr()) {
+            return traits_type::to_int_type(*gptr());
+        }
+
+        unique_lock<mutex> guard(lock);
+        if (current != NONE) {
+            free_slots.push_back(current);
+            current = NONE;
+            changed.notify_all();
+        }
+        changed.wait(guard, [&]() { return !filled.empty() || done; });
+        if (filled.empty()) {
+            if (error) {
+                exception_ptr failure = error;
+                error = nullptr;
+                rethrow_exception(failure);
+            }
+            return traits_type::eof();
+        }
+
+        auto [slot, bytes] = filled.front();
+        filled.pop_front();
+        current = slot;
+        char* start = buffers[slot].data();
+        setg(start, start, start + bytes);
+        return traits_type::to_int_type(*gptr());
+    }
+
+public:
+    explicit PipelinedReadBuf(unique_ptr<BlockDecoder> source)
+    : decoder(std::move(source)), buffers(BUFFER_COUNT, vector<char>(BUFFER_SIZE)) {
+        for (size_t slot = 0; slot < BUFFER_COUNT; slot++) {
+            free_slots.push_back(slot);
+        }
+        worker = thread([this]() { produce(); });
+    }
+
+    ~PipelinedReadBuf() override {
+        {
+            lock_guard<mutex> guard(lock);
+            stop = true;
+        }
+        changed.notify_all();
+        worker.join();
+    }
+};
+
+/**
+ * @brief Output stream buffer that compresses everything written to it.
+ */
+class CompressedWriteBuf : public streambuf {
+private:
+    unique_ptr<BlockEncoder> encoder;
+    vector<char> buffer = vector<char>(1 << 20);
+    bool closed = false;
+
+    void drain() {
+        encoder->write(pbase(), pptr() - pbase());
+        setp(buffer.data(), buffer.data() + buffer.size());
+    }
+
+protected:
+    int_type overflow(int_type ch) override {
+        drain();
+        if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+            *pptr() = traits_type::to_char_type(ch);
+            pbump(1);
+        }
+        return traits_type::not_eof(ch);
+    }
+
+    int sync() override {
+        drain();
+        return 0;
+    }
+
+public:
+    explicit CompressedWriteBuf(unique_ptr<BlockEncoder> sink) : encoder(std::move(sink)) {
+        setp(buffer.data(), buffer.data() + buffer.size());
+    }
+
+    /**
+     * @brief Compresses the buffered data and ends the compressed stream.
+     */
+    void close() {
+        if (!closed) {
+            drain();
+            encoder->finish();
+            closed = true;
+        }
+    }
+};
+
+// Arrow C Data Interface (https://arrow.apache.org/docs/format/CDataInterface.html).
+// The structs are part of the ABI and defined verbatim, so no Arrow library is needed.
+#ifndef ARROW_C_DATA_INTERFACE
+#define ARROW_C_DATA_INTERFACE
+
+#define ARROW_FLAG_DICTIONARY_ORDERED 1
+#define ARROW_FLAG_NULLABLE 2
+#define ARROW_FLAG_MAP_KEYS_SORTED 4
+
+struct ArrowSchema {
+    const char* format;
+    const char* name;
+    const char* metadata;
+    int64_t flags;
+    int64_t n_children;
+    struct ArrowSchema** children;
+    struct ArrowSchema* dictionary;
+    void (*release)(struct ArrowSchema*);
+    void* private_data;
+};
+
+struct ArrowArray {
+    int64_t length;
+    int64_t null_count;
+    int64_t offset;
+    int64_t n_buffers;
+    int64_t n_children;
+    const void** buffers;
+    struct ArrowArray** children;
+    struct ArrowArray* dictionary;
+    void (*release)(struct ArrowArray*);
+    void* private_data;
+};
+
+#endif // ARROW_C_DATA_INTERFACE
+
+/**
+ * @brief Strings referenced by an exported ArrowSchema, freed by its release callback.
+ */
+struct ArrowSchemaData {
+    string format;
+    string name;
+    vector<ArrowSchema> child_schemas;
+    vector<ArrowSchema*> children;
+};
+
+/**
+ * @brief Buffers referenced by an exported ArrowArray, freed by its release callback.
+ */
+struct ArrowArrayData {
+    vector<uint8_t> validity;      // bit i set if row i is present
+    vector<int64_t> values;        // "l" and "tsn" columns; offsets of "U" columns
+    vector<double> floats;         // "g" columns
+    vector<int32_t> offsets;       // "u" columns
+    string chars;                  // "u" and "U" columns
+    vector<const void*> buffers;
+    vector<ArrowArray> child_arrays;
+    vector<ArrowArray*> children;
+};
+
+void release_arrow_schema(ArrowSchema* schema) {
+    auto* owned = static_cast<ArrowSchemaData*>(schema->private_data);
+    for (ArrowSchema* child : owned->children) {
+        if (child->release) {
+            child->release(child);
+        }
+    }
+    delete owned;
+    schema->release = nullptr;
+}
+
+void release_arrow_array(ArrowArray* array) {
+    auto* owned = static_cast<ArrowArrayData*>(array->private_data);
+    for (ArrowArray* child : owned->children) {
+        if (child->release) {
+            child->release(child);
+        }
+    }
+    delete owned;
+    array->release = nullptr;
+}
+
+/**
+ * @brief Fills `schema` and `array` with an exported schema and its private data.
+ */
+void publish_arrow(unique_ptr<ArrowSchemaData> sdata, unique_ptr<ArrowArrayData> adata, int64_t length,
+                   int64_t null_count, ArrowSchema* schema, ArrowArray* array) {
+    *schema = ArrowSchema();
+    schema->format = sdata->format.c_str();
+    schema->name = sdata->name.c_str();
+    schema->flags = ARROW_FLAG_NULLABLE;
+    schema->n_children = sdata->children.size();
+    schema->children = sdata->children.empty() ? nullptr : sdata->children.data();
+    schema->release = release_arrow_schema;
+    schema->private_data = sdata.release();
+
+    *array = ArrowArray();
+    array->length = length;
+    array->null_count = null_count;
+    array->n_buffers = adata->buffers.size();
+    array->n_children = adata->children.size();
+    array->buffers = adata->buffers.data();
+    array->children = adata->children.empty() ? nullptr : adata->children.data();
+    array->release = release_arrow_array;
+    array->private_data = adata.release();
+}
+
+/**
+ * @brief Exports a column as an Arrow array.
+ *
+ * int columns become int64 ("l"), float columns float64 ("g"), datetime columns
+ * nanosecond timestamps in UTC ("tsn:UTC") and string columns utf8 ("u", or "U" past 2 GiB).
+ * Missing and unparsable cells are null.
+ *
+ * @param col The column to export
+ * @param schema Receives the column's type; released with its release callback
+ * @param array Receives the column's buffers; released with its release callback
+ */
+void export_arrow_column(const Column& col, ArrowSchema* schema, ArrowArray* array) {
+    auto sdata = make_unique<ArrowSchemaData>();
+    auto adata = make_unique<ArrowArrayData>();
+    sdata->name = col.name;
+
+    size_t rows = col.data.size();
+    int64_t nulls = 0;
+    vector<uint8_t>& validity = adata->validity;
+    validity.assign((rows + 7) / 8, 0);
+    auto set_valid = [&](size_t i, bool valid) {
+        if (valid) {
+            validity[i / 8] |= static_cast<uint8_t>(1u << (i % 8));
+        } else {
+            nulls++;
+        }
+    };
+
+    if (col.dtype == "int") {
+        sdata->format = "l";
+        adata->values.assign(rows, 0);
+        for (size_t i = 0; i < rows; i++) {
+            set_valid(i, parse_integer(col.data[i], adata->values[i]));
+        }
+        adata->buffers = {nullptr, adata->values.data()};
+    } else if (col.dtype == "float") {
+        sdata->format = "g";
+        adata->floats.assign(rows, 0);
+        for (size_t i = 0; i < rows; i++) {
+            set_valid(i, parse_number(col.data[i], adata->floats[i]));
+        }
+        adata->buffers = {nullptr, adata->floats.data()};
+    } else if (col.dtype == "datetime") {
+        sdata->format = "tsn:UTC";
+        adata->values = col.datetime_values();
+        for (size_t i = 0; i < rows; i++) {
+            set_valid(i, adata->values[i] != NAT);
+        }
+        adata->buffers = {nullptr, adata->values.data()};
+    } else {
+        size_t bytes = 0;
+        for (const string& cell : col.data) {
+            bytes += cell.size();
+        }
+        adata->chars.reserve(bytes);
+        bool large = bytes > static_cast<size_t>(numeric_limits<int32_t>::max());
+        sdata->format = large ? "U" : "u";
+        if (large) {
+            adata->values.reserve(rows + 1);
+            adata->values.push_back(0);
+        } else {
+            adata->offsets.reserve(rows + 1);
+            adata->offsets.push_back(0);
+        }
+        for (size_t i = 0; i < rows; i++) {
+            const string& cell = col.data[i];
+            set_valid(i, !cell.empty());
+            adata->chars += cell;
+            if (large) {
+                adata->values.push_back(adata->chars.size());
+            } else {
+                adata->offsets.push_back(adata->chars.size());
+            }
+        }
+        const void* offsets = large ? static_cast<const void*>(adata->values.data()) : adata->offsets.data();
+        adata->buffers = {nullptr, offsets, adata->chars.data()};
+    }
+
+    if (nulls > 0) {
+        adata->buffers[0] = validity.data();
+    }
+    publish_arrow(std::move(sdata), std::move(adata), rows, nulls, schema, array);
+}
+
+/**
+ * @brief Imports an Arrow array as a column, without taking ownership.
+ *
+ * Supports signed and unsigned integers and booleans (as "int"), float32/float64 ("float"),
+ * utf8 and large utf8 ("string"), and timestamps and dates of any unit ("datetime").
+ *
+ * @param schema The array's type
+ * @param array The array's buffers
+ * @param parent_offset Offset of the enclosing struct array, added to the array's own offset
+ * @param length Number of rows to read
+ * @throws invalid_argument If the format is not supported
+ * @note Null rows and empty strings become missing cells
+ */
+Column import_arrow_column(const ArrowSchema& schema, const ArrowArray& array, int64_t parent_offset, int64_t length) {
+    Column col;
+    col.name = schema.name ? schema.name : "";
+    string format = schema.format;
+    int64_t offset = parent_offset + array.offset;
+    const uint8_t* validity = array.null_count == 0 ? nullptr : static_cast<const uint8_t*>(array.buffers[0]);
+    auto valid = [&](int64_t i) {
+        return validity == nullptr || (validity[i / 8] >> (i % 8)) & 1;
+    };
+
+    vector<string> cells(length);
+    auto convert = [&](auto tag, auto format_cell) {
+        using T = decltype(tag);
+        const T* values = static_cast<const T*>(array.buffers[1]);
+        for (int64_t i = 0; i < length; i++) {
+            if (valid(offset + i)) {
+                cells[i] = format_cell(values[offset + i]);
+            }
+        }
+    };
+    auto integer = [](auto v) { return to_string(v); };
+    auto scaled_datetime = [](int64_t scale) {
+        return [scale](auto v) { return format_datetime(static_cast<int64_t>(v) * scale); };
+    };
+
+    if (format.size() == 1 && string("cCsSiIlL").find(format[0]) != string::npos) {
+        col.dtype = "int";
+        switch (format[0]) {
+            case 'c': convert(int8_t(), integer); break;
+            case 'C': convert(uint8_t(), integer); break;
+            case 's': convert(int16_t(), integer); break;
+            case 'S': convert(uint16_t(), integer); break;
+            case 'i': convert(int32_t(), integer); break;
+            case 'I': convert(uint32_t(), integer); break;
+            case 'l': convert(int64_t(), integer); break;
+            default: convert(uint64_t(), integer); break;
+        }
+    } else if (format == "b") {
+        col.dtype = "int";
+        const uint8_t* bits = static_cast<const uint8_t*>(array.buffers[1]);
+        for (int64_t i = 0; i < length; i++) {
+            if (valid(offset + i)) {
+                cells[i] = (bits[(offset + i) / 8] >> ((offset + i) % 8)) & 1 ? "1" : "0";
+            }
+        }
+    } else if (format == "g" || format == "f") {
+        col.dtype = "float";
+        auto number = [](double v) { return format_number(v); };
+        if (format == "g") {
+            convert(double(), number);
+        } else {
+            convert(float(), number);
+        }
+    } else if (format == "u" || format == "U") {
+        col.dtype = "string";
+        const char* chars = static_cast<const char*>(array.buffers[2]);
+        for (int64_t i = 0; i < length; i++) {
+            if (!valid(offset + i)) {
+                continue;
+            }
+            int64_t start, stop;
+            if (format == "u") {
+                const int32_t* offsets = static_cast<const int32_t*>(array.buffers[1]);
+                start = offsets[offset + i];
+                stop = offsets[offset + i + 1];
+            } else {
+                const int64_t* offsets = static_cast<const int64_t*>(array.buffers[1]);
+                start = offsets[offset + i];
+                stop = offsets[offset + i + 1];
+            }
+            cells[i].assign(chars + start, stop - start);
+        }
+    } else if (format.compare(0, 2, "ts") == 0 && format.size() >= 4 && format[3] == ':') {
+        // timestamps are stored in UTC whatever the timezone annotation
+        col.dtype = "datetime";
+        switch (format[2]) {
+            case 's': convert(int64_t(), scaled_datetime(1000000000)); break;
+            case 'm': convert(int64_t(), scaled_datetime(1000000)); break;
+            case 'u': convert(int64_t(), scaled_datetime(1000)); break;
+            case 'n': convert(int64_t(), scaled_datetime(1)); break;
+            default: throw invalid_argument("Invalid argument: unsupported Arrow format `" + format + "`");
+        }
+    } else if (format == "tdD") {
+        col.dtype = "datetime";
+        convert(int32_t(), scaled_datetime(86400LL * 1000000000));
+    } else if (format == "tdm") {
+        col.dtype = "datetime";
+        convert(int64_t(), scaled_datetime(1000000));
+    } else {
+        throw invalid_argument("Invalid argument: unsupported Arrow format `" + format + "`");
+    }
+
+    col.data = std::move(cells);
+    col.build_statistics();
+    return col;
+}
+
+/**
+ * @brief A DataFrame class for handling tabular data similar to pandas DataFrame.
+ * 
+ * The DataFrame class provides functionality to load CSV files, manipulate data,
+ * perform filtering operations, and save results. It automatically detects column
+ * data types and provides various data analysis methods.
+ */
+class DataFrame {
+private:
+    friend class SharedFrame;
+    friend class OutOfCoreFrame;
+    template <typename Schema>
+    friend class TypedFrame;
+
+    map<string, shared_ptr<Column>> col_data; // columns may be shared with SharedFrame snapshots until written
+    string file_dir;
+
+    /**
+     * @brief Returns a column for modification, first copying it if another version still shares it.
+     */
+    Column& write_column(shared_ptr<Column>& col) {
+        if (col.use_count() > 1) {
+            col = make_shared<Column>(*col);
+        }
+        return *col;
+    }
+
+    Column& write_column(const string& col_name) {
+        return write_column(col_data.at(col_name));
+    }
+
+    /**
+     * @brief Appends a column to the end of the DataFrame.
+     */
+    void append_column(Column col) {
+        string col_name = col.name;
+        columns.push_back(col_name);
+        col_data.insert_or_assign(col_name, make_shared<Column>(std::move(col)));
+    }
+
+    /**
+     * @brief Reads CSV rows from `path`, starting at byte `from_offset`, and appends them to the columns.
+     *
+     * @param partial_last_line If false, a last line without a trailing newline is left unread
+     * @param options Column projection, row limits, delimiter and quote character
+     * @param batch_bytes With `on_batch`, the approximate memory of buffered rows that triggers a batch
+     *                    once it holds at least MIN_BATCH_ROWS rows
+     * @param on_batch If set, called whenever a batch of rows (at most Column::ZONE_SIZE) has been appended
+     *                 to the columns, and once more for the last partial batch; it may consume and clear them
+     * @param on_cells If set, receives each batch of cells (one vector per column, in `columns` order) instead of
+     *                 the columns, which then stay empty: no dtypes are inferred and no statistics are built
+     * @return The byte offset just past the last record read (in decompressed bytes for compressed files)
+     * @note gzip and zstd files are detected from their magic bytes
+     */
+    size_t read_csv(const string& path, size_t from_offset, bool partial_last_line, const CsvOptions& options,
+                    size_t batch_bytes = 0, const function<void()>& on_batch = nullptr,
+                    const function<void(const vector<vector<string>>&)>& on_cells = nullptr) {
+        // a batch is handed to all columns in parallel, which is not worth it for a handful of rows
+        const size_t MIN_BATCH_ROWS = 1024;
+
+        ifstream raw(path, ios::binary);
+
+        if (!raw) {
+            throw runtime_error("Error: File not found!");
+        }
+
+        // compressed input is decompressed by a background thread while this one parses
+        string compression = detect_compression(path);
+        unique_ptr<PipelinedReadBuf> decompressed;
+        if (compression != "none") {
+            decompressed = make_unique<PipelinedReadBuf>(make_decoder(compression, path));
+        } else if (from_offset > std::filesystem::file_size(path)) {
+            throw std::out_of_range("Offset is past the end of the file!");
+        }
+        istream file(decompressed ? static_cast<streambuf*>(decompressed.get()) : raw.rdbuf());
+        file.exceptions(ios::badbit);
+
+        char delim = options.delimiter;
+        char quote = options.quotechar;
+        size_t consumed = 0;
+        string line;
+        string record;
+        vector<string> fields;
+        size_t field_count = 0;
+        vector<char> selected; // empty until the header has been read
+
+        // reads and tokenizes one (possibly multi-line) record; returns false at the end of the usable input
+        auto next_record = [&]() {
+            record.clear();
+            while (getline(file, line)) {
+                bool terminated = !file.eof();
+                if (!terminated && !partial_last_line) {
+                    return false;
+                }
+                consumed += line.size() + terminated;
+                record += line;
+                if (tokenize_record(record, delim, quote, selected, fields, field_count) || !terminated) {
+                    return true;
+                }
+                // a quoted field continues on the next line
+                record += '\n';
+            }
+            return false;
+        };
+
+        for (size_t skipped = 0; skipped < options.skiprows && getline(file, line); skipped++) {
+            consumed += line.size() + !file.eof();
+        }
+
+        // the header decides which fields are selected, so it is read even when resuming
+        if (!next_record()) {
+            return std::max(from_offset, consumed);
+        }
+        vector<string> header = fields;
+        size_t header_width = field_count;
+
+        vector<string> names = header;
+        if (!options.usecols.empty()) {
+            selected.assign(header.size(), false);
+            names.clear();
+            for (const string& col_name : options.usecols) {
+                auto it = std::find(header.begin(), header.end(), col_name);
+                if (it == header.end()) {
+                    throw std::out_of_range("Column not found: " + col_name);
+                }
+                selected[it - header.begin()] = true;
+            }
+            for (size_t jdx = 0; jdx < header.size(); jdx++) {
+                if (selected[jdx]) {
+                    names.push_back(header[jdx]);
+                }
+            }
+        }
+
+        if (columns.empty()) {
+            for (const string& element : names) {
+                Column col;
+                col.name = element;
+                append_column(std::move(col));
+            }
+        } else if (names != columns) {
+            throw runtime_error("Error: CSV header does not match the DataFrame's columns!");
+        }
+
+        if (from_offset != 0) {
+            if (from_offset < consumed) {
+                throw std::out_of_range("Offset is inside the header!");
+            }
+            file.clear();
+            if (decompressed) {
+                // offsets count decompressed bytes, which can only be skipped by reading them
+                file.ignore(from_offset - consumed);
+                if (static_cast<size_t>(file.gcount()) != from_offset - consumed) {
+                    throw std::out_of_range("Offset is past the end of the file!");
+                }
+            } else {
+                file.seekg(from_offset);
+            }
+            consumed = from_offset;
+        }
+
+        size_t offset = consumed;
+        size_t rows = 0;
+        vector<vector<string>> new_cells(columns.size());
+        auto append_cells = [&]() {
+            if (on_cells) {
+                on_cells(new_cells);
+                for (vector<string>& cells : new_cells) {
+                    cells.clear();
+                }
+                return;
+            }
+            parallel_for(columns.size(), [&](size_t jdx) {
+                string cells_dtype = infer_dtype(new_cells[jdx]);
+                write_column(columns[jdx]).append(std::move(new_cells[jdx]), cells_dtype);
+                new_cells[jdx].clear();
+            });
+        };
+
+        size_t batch_rows = 0;
+        size_t batch_memory = 0;
+        while ((options.nrows == 0 || rows < options.nrows) && next_record()) {
+            size_t record_bytes = consumed - offset;
+            offset = consumed;
+            if (field_count == 0) {
+                // blank line
+                continue;
+            }
+            if (field_count > header_width) {
+                throw runtime_error("Error: Row has more fields than the DataFrame has columns!");
+            }
+            for (size_t jdx = 0; jdx < columns.size(); jdx++) {
+                // missing trailing elements are empty
+                new_cells[jdx].push_back(jdx < fields.size() ? std::move(fields[jdx]) : "");
+            }
+            rows++;
+
+            if (on_batch || on_cells) {
+                batch_memory += record_bytes + columns.size() * sizeof(string);
+                if (++batch_rows == Column::ZONE_SIZE || (batch_rows >= MIN_BATCH_ROWS && batch_memory >= batch_bytes)) {
+                    append_cells();
+                    if (on_batch) {
+                        on_batch();
+                    }
+                    batch_rows = 0;
+                    batch_memory = 0;
+                }
+            }
+        }
+
+        append_cells();
+        if (on_batch && batch_rows > 0) {
+            on_batch();
+        }
+        return offset;
+    }
+
+    /**
+     * @brief Computes the pairwise covariance or correlation of all numeric columns.
+     *
+     * The rows are split into one contiguous range per thread. Each thread parses its range block by
+     * block into its own row-major float64 panel (shifted by each column's mean to limit cancellation)
+     * and accumulates its own moment sums of every column pair, tile by tile, with an inner loop over
+     * contiguous columns that the compiler can vectorize. The per-thread sums are added at the end.
+     * When any column has missing values, the moments are restricted to the rows where both columns
+     * are present.
+     *
+     * @param normalize If true, returns Pearson correlations instead of covariances
+     * @return A DataFrame with a "column" name column followed by one column per numeric column
+     */
+    DataFrame pairwise_moments(bool normalize) const {
+        const size_t TILE = 64;
+        const size_t ROW_BLOCK = 4096;
+        const size_t MAX_SUMS_BYTES = size_t(256) << 20; // bound on the per-thread moment sums
+
+        vector<const Column*> numeric;
+        bool pairwise = false;
+        for (const string& col_name : columns) {
+            const Column& col = *col_data.at(col_name);
+            if (col.is_numeric()) {
+                numeric.push_back(&col);
+                pairwise = pairwise || col.stats().null_count > 0;
+            }
+        }
+
+        size_t k = numeric.size();
+        size_t rows = nrows();
+        vector<double> shift(k);
+        for (size_t c = 0; c < k; c++) {
+            const ColumnStats& st = numeric[c]->stats();
+            shift[c] = st.count == 0 ? 0 : st.sum / static_cast<double>(st.count);
+        }
+
+        vector<pair<size_t, size_t>> tile_pairs;
+        for (size_t a = 0; a * TILE < k; a++) {
+            for (size_t b = a; b * TILE < k; b++) {
+                tile_pairs.push_back({a, b});
+            }
+        }
+
+        // moment sums of every (i, j) pair, row-major k x k; only i's tile <= j's tile is filled.
+        // Only sxy is needed, alongside the per-column sums, when no column has missing values.
+        struct Moments {
+            vector<double> cnt, sx, sy, sxx, syy, sxy;
+            vector<double> col_sum, col_sq;
+        };
+        size_t pair_sums = pairwise ? 6 : 1;
+        size_t sums_bytes = (pair_sums * k * k + 2 * k) * sizeof(double);
+        size_t blocks = (rows + ROW_BLOCK - 1) / ROW_BLOCK;
+        size_t workers = std::min<size_t>({blocks, std::max(1u, thread::hardware_concurrency()),
+                                           MAX_SUMS_BYTES / std::max<size_t>(sums_bytes, 1)});
+        workers = std::max<size_t>(workers, 1);
+
+        vector<Moments> partial(workers);
+        parallel_for(workers, [&](size_t w) {
+            Moments& mo = partial[w];
+            mo.sxy.assign(k * k, 0);
+            if (pairwise) {
+                mo.cnt.assign(k * k, 0);
+                mo.sx.assign(k * k, 0);
+                mo.sy.assign(k * k, 0);
+                mo.sxx.assign(k * k, 0);
+                mo.syy.assign(k * k, 0);
+            }
+            mo.col_sum.assign(k, 0);
+            mo.col_sq.assign(k, 0);
+
+            size_t first = std::min(rows, blocks * w / workers * ROW_BLOCK);
+            size_t last = std::min(rows, blocks * (w + 1) / workers * ROW_BLOCK);
+            vector<double> x(ROW_BLOCK * k), m(ROW_BLOCK * k);
+            for (size_t start = first; start < last; start += ROW_BLOCK) {
+                size_t len = std::min(ROW_BLOCK, last - start);
+
+                for (size_t c = 0; c < k; c++) {
+                    const vector<string>& cells = numeric[c]->data;
+                    for (size_t r = 0; r < len; r++) {
+                        double num;
+                        bool valid = parse_number(cells[start + r], num);
+                        x[r * k + c] = valid ? num - shift[c] : 0;
+                        m[r * k + c] = valid;
+                        mo.col_sum[c] += x[r * k + c];
+                        mo.col_sq[c] += x[r * k + c] * x[r * k + c];
+                    }
+                }
+
+                for (const auto& [a, b] : tile_pairs) {
+                    size_t i0 = a * TILE, i1 = std::min(i0 + TILE, k);
+                    size_t j0 = b * TILE, j1 = std::min(j0 + TILE, k);
+                    for (size_t r = 0; r < len; r++) {
+                        const double* __restrict xr = &x[r * k];
+                        const double* __restrict mr = &m[r * k];
+                        for (size_t i = i0; i < i1; i++) {
+                            double xi = xr[i];
+                            if (!pairwise) {
+                                double* __restrict out_xy = &mo.sxy[i * k];
+                                for (size_t j = j0; j < j1; j++) {
+                                    out_xy[j] += xi * xr[j];
+                                }
+                                continue;
+                            }
+                            if (mr[i] == 0) {
+                                continue;
+                            }
+                            double* __restrict out_n = &mo.cnt[i * k];
+                            double* __restrict out_x = &mo.sx[i * k];
+                            double* __restrict out_y = &mo.sy[i * k];
+                            double* __restrict out_xx = &mo.sxx[i * k];
+                            double* __restrict out_yy = &mo.syy[i * k];
+                            double* __restrict out_xy = &mo.sxy[i * k];
+                            for (size_t j = j0; j < j1; j++) {
+                                out_n[j] += mr[j];
+                                out_x[j] += xi * mr[j];
+                                out_y[j] += xr[j];
+                                out_xx[j] += xi * xi * mr[j];
+                                out_yy[j] += xr[j] * xr[j];
+                                out_xy[j] += xi * xr[j];
+                            }
+                        }
+                    }
+                }
+            }
+        });
+
+        // add the per-thread sums in thread order, so the result does not depend on scheduling
+        Moments total = std::move(partial[0]);
+        auto add_to = [](vector<double>& into, const vector<double>& from) {
+            for (size_t i = 0; i < from.size(); i++) {
+                into[i] += from[i];
+            }
+        };
+        for (size_t w = 1; w < workers; w++) {
+            add_to(total.cnt, partial[w].cnt);
+            add_to(total.sx, partial[w].sx);
+            add_to(total.sy, partial[w].sy);
+            add_to(total.sxx, partial[w].sxx);
+            add_to(total.syy, partial[w].syy);
+            add_to(total.sxy, partial[w].sxy);
+            add_to(total.col_sum, partial[w].col_sum);
+            add_to(total.col_sq, partial[w].col_sq);
+        }
+        const vector<double>& cnt = total.cnt;
+        const vector<double>& sx = total.sx;
+        const vector<double>& sy = total.sy;
+        const vector<double>& sxx = total.sxx;
+        const vector<double>& syy = total.syy;
+        const vector<double>& sxy = total.sxy;
+        const vector<double>& col_sum = total.col_sum;
+        const vector<double>& col_sq = total.col_sq;
+
+        vector<double> result(k * k);
+        for (size_t i = 0; i < k; i++) {
+            for (size_t j = i; j < k; j++) {
+                size_t p = i * k + j;
+                double n = pairwise ? cnt[p] : static_cast<double>(rows);
+                double sum_x = pairwise ? sx[p] : col_sum[i];
+                double sum_y = pairwise ? sy[p] : col_sum[j];
+                double sum_xx = pairwise ? sxx[p] : col_sq[i];
+                double sum_yy = pairwise ? syy[p] : col_sq[j];
+
+                double value = numeric_limits<double>::quiet_NaN();
+                double co = sxy[p] - sum_x * sum_y / n;
+                if (n >= 2 && !normalize) {
+                    value = co / (n - 1);
+                } else if (n >= 2) {
+                    double var_x = sum_xx - sum_x * sum_x / n;
+                    double var_y = sum_yy - sum_y * sum_y / n;
+                    if (var_x > 0 && var_y > 0) {
+                        value = std::clamp(co / sqrt(var_x * var_y), -1.0, 1.0);
+                    }
+                }
+                result[i * k + j] = value;
+                result[j * k + i] = value;
+            }
+        }
+
+        DataFrame matrix;
+        Column labels;
+        labels.name = "column";
+        for (const Column* col : numeric) {
+            labels.data.push_back(col->name);
+        }
+        labels.build_statistics();
+        matrix.append_column(std::move(labels));
+
+        for (size_t j = 0; j < k; j++) {
+            Column values;
+            values.name = numeric[j]->name;
+            values.dtype = "float";
+            for (size_t i = 0; i < k; i++) {
+                values.data.push_back(format_number(result[i * k + j]));
+            }
+            values.build_statistics();
+            matrix.append_column(std::move(values));
+        }
+        return matrix;
+    }
+
+public:
+    vector<string> columns;
+
+    /**
+     * @brief Default constructor for creating an empty DataFrame.
+     */
+    DataFrame() = default;
+    
+    /**
+     * @brief Copy constructor for creating a DataFrame from another DataFrame.
+     * 
+     * @param other The DataFrame to copy from
+     */
+    DataFrame(const DataFrame& other)
+    : file_dir(other.file_dir), columns(other.columns) {
+        for (const auto& [col_name, col] : other.col_data) {
+            col_data.emplace(col_name, make_shared<Column>(*col));
+        }
+    }
+
+    DataFrame(DataFrame&& other) = default;
+
+    /**
+     * @brief Assignment operator; copies the columns of an lvalue and moves those of an rvalue.
+     */
+    DataFrame& operator=(DataFrame other) {
+        col_data.swap(other.col_data);
+        file_dir.swap(other.file_dir);
+        columns.swap(other.columns);
+        return *this;
+    }
+
+    /**
+     * @brief Constructor that loads data from a CSV file.
+     * 
+     * @param new_file_dir Path to the CSV file to load
+     * @throws runtime_error If the file cannot be found or opened
+     * @note Automatically detects column data types (int, float, or string)
+     * @note Handles missing values in CSV files
+     * @note gzip and zstd compressed files are detected and decompressed on a background thread
+     */
+    DataFrame(string new_file_dir) {
+        file_dir = new_file_dir;
+        read_csv(file_dir, 0, true, CsvOptions());
+    }
+
+    /**
+     * @brief Constructor that loads data from a CSV file with read options.
+     * 
+     * @param new_file_dir Path to the CSV file to load
+     * @param options Columns to load (`usecols`), row limits (`nrows`, `skiprows`), `delimiter` and `quotechar`
+     * @throws runtime_error If the file cannot be found or opened
+     * @throws std::out_of_range If a column in `options.usecols` is not in the file
+     * @note Unselected columns are skipped by the tokenizer: they are never copied, stored or type-inferred
+     */
+    DataFrame(string new_file_dir, const CsvOptions& options) {
+        file_dir = new_file_dir;
+        read_csv(file_dir, 0, true, options);
+    }
+
+    /**
+     * @brief Appends the rows of a CSV file, starting at a byte offset, to the DataFrame.
+     * 
+     * @param path Path to the CSV file
+     * @param from_offset Byte offset to resume from (0 = the first row after the header)
+     * @param options Read options, as for the constructor; `nrows` limits the rows read by this call
+     * @return The offset just past the last line read, to pass to the next call
+     * @throws runtime_error If the file cannot be opened, or its header or rows do not match the columns
+     * @throws std::out_of_range If `from_offset` is inside the header or past the end of the file
+     * @note The header is always read and checked against the columns
+     * @note Only newline-terminated lines are read, so a line that is still being written is picked up by the next call
+     * @note Column dtypes are widened (int -> float -> string) as needed; existing cells are not reparsed
+     */
+    size_t append_csv(const string& path, size_t from_offset = 0, const CsvOptions& options = CsvOptions()) {
+        return read_csv(path, from_offset, false, options);
+    }
+
+    /**
+     * @brief Appends the rows of another DataFrame with the same columns.
+     * 
+     * @param other The DataFrame to append
+     * @throws runtime_error If the columns of `other` do not match (an empty DataFrame takes them over)
+     * @note Column dtypes are widened as needed and cached statistics are extended, not rebuilt
+     */
+    void append(const DataFrame& other) {
+        if (columns.empty()) {
+            for (const string& col_name : other.columns) {
+                Column col;
+                col.name = col_name;
+                append_column(std::move(col));
+            }
+        } else if (other.columns != columns) {
+            throw runtime_error("Error: Columns do not match!");
+        }
+
+        parallel_for(columns.size(), [&](size_t j) {
+            const Column& source = *other.col_data.at(columns[j]);
+            write_column(columns[j]).append(source.data, source.dtype);
+        });
+    }
+
+    /**
+     * @brief Concatenates DataFrames with the same columns, one after another.
+     * 
+     * @param frames The DataFrames to concatenate
+     * @return A new DataFrame holding the rows of every frame in order
+     * @throws runtime_error If the frames' columns do not match
+     */
+    static DataFrame concat(const vector<DataFrame>& frames) {
+        DataFrame result;
+        for (const DataFrame& frame : frames) {
+            result.append(frame);
+        }
+        return result;
+    }
+
+    /**
+     * @brief Exports the DataFrame through the Arrow C Data Interface, as a struct array with one child per column.
+     * 
+     * @param schema Receives the schema ("+s" with one child per column)
+     * @param array Receives the data; the consumer calls each struct's release callback when done
+     * @note Cells are stored as strings, so each column is converted once into Arrow buffers (in parallel);
+     *       those buffers are then handed over without further copies and freed by the release callbacks
+     * @see export_arrow_column() for the column type mapping
+     */
+    void export_arrow(ArrowSchema* schema, ArrowArray* array) const {
+        size_t k = columns.size();
+        auto sdata = make_unique<ArrowSchemaData>();
+        auto adata = make_unique<ArrowArrayData>();
+        sdata->format = "+s";
+        sdata->child_schemas.resize(k);
+        adata->child_arrays.resize(k);
+        for (size_t j = 0; j < k; j++) {
+            sdata->children.push_back(&sdata->child_schemas[j]);
+            adata->children.push_back(&adata->child_arrays[j]);
+        }
+        adata->buffers = {nullptr};
+
+        try {
+            parallel_for(k, [&](size_t j) {
+                export_arrow_column(*col_data.at(columns[j]), &sdata->child_schemas[j], &adata->child_arrays[j]);
+            });
+        } catch (...) {
+            for (size_t j = 0; j < k; j++) {
+                if (sdata->child_schemas[j].release) {
+                    sdata->child_schemas[j].release(&sdata->child_schemas[j]);
+                }
+                if (adata->child_arrays[j].release) {
+                    adata->child_arrays[j].release(&adata->child_arrays[j]);
+                }
+            }
+            throw;
+        }
+        publish_arrow(std::move(sdata), std::move(adata), nrows(), 0, schema, array);
+    }
+
+    /**
+     * @brief Imports a struct array through the Arrow C Data Interface, one column per child.
+     * 
+     * @param schema The schema of a struct array ("+s")
+     * @param array The struct array; its offset and length select the rows
+     * @return A new DataFrame holding the imported rows
+     * @throws invalid_argument If the schema is not a struct or a child type is not supported
+     * @note Takes ownership: both structs are released before returning, even on error
+     * @see import_arrow_column() for the supported types
+     */
+    static DataFrame from_arrow(ArrowSchema* schema, ArrowArray* array) {
+        unique_ptr<ArrowSchema, void (*)(ArrowSchema*)> schema_guard(schema, [](ArrowSchema* s) {
+            if (s->release) {
+                s->release(s);
+            }
+        });
+        unique_ptr<ArrowArray, void (*)(ArrowArray*)> array_guard(array, [](ArrowArray* a) {
+            if (a->release) {
+                a->release(a);
+            }
+        });
+        if (string(schema->format) != "+s" || schema->n_children != array->n_children) {
+            throw invalid_argument("Invalid argument: DataFrame::from_arrow() expects a struct array");
+        }
+
+        size_t k = schema->n_children;
+        vector<optional<Column>> imported(k);
+        parallel_for(k, [&](size_t j) {
+            imported[j].emplace(import_arrow_column(*schema->children[j], *array->children[j], array->offset, array->length));
+        });
+
+        DataFrame df;
+        for (optional<Column>& col : imported) {
+            if (df.col_data.count(col->name)) {
+                throw invalid_argument("Invalid argument: duplicate column name `" + col->name + "`");
+            }
+            df.append_column(std::move(*col));
+        }
+        return df;
+    }
+
+    /**
+     * @brief Prints the DataFrame with various formatting options.
+     * 
+     * @param rows_cnt Number of rows to print (0 = print all rows)
+     * @param is_tail If 1, prints from the end; if 0, prints from the beginning
+     * @param cols Vector of column names to print (empty = print all columns)
      * @throws std::out_of_range If any specified column is not found
      */
-    void print(int rows_cnt = 0, int is_tail = 0, vector<string> cols = {}) const {
-        if (rows_cnt == 0) {
-            rows_cnt = row_data.size();
+    void print(int rows_cnt = 0, int is_tail = 0, vector<string> cols = {}) const {
+        size_t total_rows = nrows() + 1; // including the header
+        if (rows_cnt == 0) {
+            rows_cnt = total_rows;
+        }
+
+        if (cols.size() == 0) {
+            cols = columns;
+        }
+
+        vector<vector<string>> print_row_data;
+        vector<string> col_name_row;
+        size_t sz = 0;
+        for(string col : cols) {
+            bool found = false;
+            for (auto it = col_data.rbegin(); it != col_data.rend(); ++it) {
+                if (col == it->second->name) {
+                    col_name_row.push_back(it->second->name);
+                    sz = it->second->data.size();
+                    found = true;
+                    break;
+                }
+            }
+
+            if (!found) {
+                throw std::out_of_range("Column not found!");
+            }
+        }
+        print_row_data.push_back(col_name_row);
+
+        for(size_t idx = 0; idx < sz; idx++) {
+            vector<string> new_row;
+            for(string col : cols) {
+                for (auto it = col_data.rbegin(); it != col_data.rend(); ++it) {
+                    if (col == it->second->name) {
+                        new_row.push_back(it->second->data[idx]);
+                        break;
+                    }
+                }
+            }
+            print_row_data.push_back(new_row);
+        }
+
+        size_t idx = 0;
+        for(auto& row : print_row_data) {
+            cout << std::left;
+            if (is_tail && idx < static_cast<size_t>(total_rows-rows_cnt)) {
+                if (idx == 0) {
+                    for(auto& element : row) {
+                        cout << setw(20) << element;
+                    }
+                    cout << endl;
+                }
+                idx++;
+                continue;
+            }
+            for(auto& element : row) {
+                cout << setw(20) << element;
+            }
+            cout << endl;
+            idx++;
+            if (idx == static_cast<size_t>(rows_cnt + 1) && !is_tail) {
+                break;
+            }
+
+            if (idx == total_rows && is_tail) {
+                break;
+            }
+        }
+        cout << "\nPrinted: " << print_row_data.size() << " rows\n";
+    }
+
+    /**
+     * @brief Displays the first N rows of the DataFrame.
+     * 
+     * @param rows_cnt Number of rows to display from the beginning (default: 5)
+     */
+    void head(int rows_cnt = 5) const {
+        print(rows_cnt);
+    };
+
+    /**
+     * @brief Displays the last N rows of the DataFrame.
+     * 
+     * @param rows_cnt Number of rows to display from the end (default: 5)
+     */
+    void tail(int rows_cnt = 5) const {
+        print(rows_cnt, 1);
+    };
+
+    /**
+     * @brief Returns the number of data rows (excluding the header).
+     */
+    size_t nrows() const {
+        if (columns.empty()) {
+            return 0;
+        }
+        return col_data.at(columns[0])->data.size();
+    }
+
+    /**
+     * @brief Renames columns in the DataFrame.
+     * 
+     * @param vec Vector of pairs containing (old_name, new_name) mappings
+     * @throws std::out_of_range If any old column name is not found
+     */
+    void rename(vector<pair<string, string>> vec) {
+        for(pair<string, string> col_pair : vec) {
+            string old_col_name = col_pair.first;
+            string new_col_name = col_pair.second;
+
+            auto it = col_data.find(old_col_name);
+            if (it != col_data.end()) {
+                shared_ptr<Column> col = std::move(it->second);
+                col_data.erase(it);
+                write_column(col).name = new_col_name;
+                col_data[new_col_name] = std::move(col);
+
+                for(string &col : columns) {
+                    if (col == old_col_name) {
+                        col = new_col_name;
+                    }
+                }
+                continue;
+            }
+
+            throw std::out_of_range("Column not found!");
+        }
+    }
+
+    /**
+     * @brief Fills all missing values in the DataFrame with a specified value.
+     * 
+     * @tparam T The type of the fill value (int, double, or string)
+     * @param x The value to use for filling missing entries
+     * @note Applies to all columns in the DataFrame
+     */
+    template <typename T>
+    void fillna(T x) {
+        for (auto it = col_data.begin(); it != col_data.end(); ++it) {
+            write_column(it->second).data.update([&](vector<string>& cells) {
+                for (string &element : cells) {
+                    if (element.length() == 0) {
+                        if constexpr (is_same<T, int>::value || is_same<T, double>::value) {
+                            element = to_string(x);
+                        } else {
+                            element = x;
+                        }
+                    }
+                }
+            });
+        }
+    }
+
+    /**
+     * @brief Removes rows from the DataFrame where the specified column has missing values.
+     * 
+     * @param col The name of the column to check for missing values
+     * @throws std::out_of_range If the column is not found
+     * @note Removes entire rows across all columns when the specified column has empty values
+     */
+    void dropna(const string& col) {
+        dropna(vector<string>{col});
+    }
+
+    /**
+     * @brief Removes rows with missing values in any or all of the given columns.
+     * 
+     * @param subset Names of the columns to check for missing values (empty = all columns)
+     * @param how "any" drops a row if any checked value is missing, "all" only if all of them are
+     * @param thresh If non-zero, keeps rows with at least `thresh` non-missing checked values and ignores `how`
+     * @throws std::out_of_range If any column in `subset` is not found
+     * @throws invalid_argument If `how` is not "any" or "all"
+     * @note Each column is compacted in a single stable pass, with columns processed in parallel
+     */
+    void dropna(const vector<string>& subset, const string& how = "any", size_t thresh = 0) {
+        if (how != "any" && how != "all") {
+            throw invalid_argument("Invalid argument: DataFrame::dropna() expects `how` to be \"any\" or \"all\"");
+        }
+
+        vector<const Column*> checked;
+        for (const string& col_name : subset.empty() ? columns : subset) {
+            auto it = col_data.find(col_name);
+            if (it == col_data.end()) {
+                throw std::out_of_range("Column not found: " + col_name);
+            }
+            checked.push_back(it->second.get());
+        }
+
+        // count the non-missing checked values of every row
+        size_t rows = nrows();
+        vector<size_t> present(rows, 0);
+        for (const Column* col : checked) {
+            const vector<string>& cells = col->data;
+            for (size_t idx = 0; idx < rows; idx++) {
+                present[idx] += !cells[idx].empty();
+            }
+        }
+
+        size_t required = thresh != 0 ? thresh : (how == "any" ? checked.size() : 1);
+        vector<char> keep(rows);
+        size_t kept = 0;
+        for (size_t idx = 0; idx < rows; idx++) {
+            keep[idx] = present[idx] >= required;
+            kept += keep[idx];
+        }
+        if (kept == rows) {
+            return;
+        }
+
+        vector<Column*> targets;
+        for (auto it = col_data.begin(); it != col_data.end(); ++it) {
+            targets.push_back(&write_column(it->second));
+        }
+
+        parallel_for(targets.size(), [&](size_t t) {
+            targets[t]->data.update([&](vector<string>& cells) {
+                size_t out = 0;
+                for (size_t idx = 0; idx < cells.size(); idx++) {
+                    if (keep[idx]) {
+                        if (out != idx) {
+                            cells[out] = std::move(cells[idx]);
+                        }
+                        out++;
+                    }
+                }
+                cells.resize(out);
+            });
+        });
+    }
+
+    /**
+     * @brief Overload so that `dropna({"a", "b"})` selects the multi-column form.
+     */
+    void dropna(initializer_list<string> subset, const string& how = "any", size_t thresh = 0) {
+        dropna(vector<string>(subset), how, thresh);
+    }
+
+    /**
+     * @brief Returns a copy of the DataFrame without duplicate rows.
+     *
+     * @param subset Names of the columns that identify a duplicate (empty = all columns)
+     * @param keep "first" or "last" keeps that occurrence of each duplicate; "none" drops all of them
+     * @return A new DataFrame with the remaining rows in their original order
+     * @throws std::out_of_range If any column in `subset` is not found
+     * @throws invalid_argument If `keep` is not "first", "last" or "none"
+     * @note Row hashes combine the hashes of the subset cells; rows are grouped in parallel by hash partition
+     */
+    DataFrame drop_duplicates(const vector<string>& subset = {}, const string& keep = "first") const {
+        if (keep != "first" && keep != "last" && keep != "none") {
+            throw invalid_argument("Invalid argument: DataFrame::drop_duplicates() expects `keep` to be \"first\", \"last\" or \"none\"");
+        }
+
+        vector<const vector<string>*> keys;
+        for (const string& col_name : subset.empty() ? columns : subset) {
+            auto it = col_data.find(col_name);
+            if (it == col_data.end()) {
+                throw std::out_of_range("Column not found: " + col_name);
+            }
+            keys.push_back(&static_cast<const vector<string>&>(it->second->data));
+        }
+
+        size_t rows = nrows();
+        vector<uint64_t> hashes(rows);
+        parallel_for((rows + Column::ZONE_SIZE - 1) / Column::ZONE_SIZE, [&](size_t b) {
+            size_t stop = std::min((b + 1) * Column::ZONE_SIZE, rows);
+            for (size_t i = b * Column::ZONE_SIZE; i < stop; i++) {
+                uint64_t h = 0;
+                for (const vector<string>* cells : keys) {
+                    h = mix_hash(h ^ hash<string_view>{}((*cells)[i]));
+                }
+                hashes[i] = h;
+            }
+        });
+
+        auto groups = group_rows(hashes, [&](size_t a, size_t b) {
+            for (const vector<string>* cells : keys) {
+                if ((*cells)[a] != (*cells)[b]) {
+                    return false;
+                }
+            }
+            return true;
+        }, keep == "last");
+
+        Mask mask(rows);
+        for (const auto& group : groups) {
+            if (keep != "none" || group.second == 1) {
+                mask.set(group.first);
+            }
+        }
+        return (*this)[mask];
+    }
+
+    /**
+     * @brief Adds a column computed from an expression, or replaces it if it already exists.
+     * 
+     * @param name The name of the new column
+     * @param expr Column arithmetic, e.g. `df["price"] * df["qty"] - df["discount"]`
+     * @throws invalid_argument If the expression's length does not match the DataFrame
+     * @note The expression is evaluated in a single fused pass, without intermediate columns
+     */
+    template <typename E>
+    void assign(const string& name, const Expr<E>& expr) {
+        assign(name, expr.evaluate(name));
+    }
+
+    /**
+     * @brief Adds a copy of a column under a new name, or replaces the column if it already exists.
+     * 
+     * @param name The name of the new column
+     * @param col The column to copy
+     * @throws invalid_argument If the column's length does not match the DataFrame
+     */
+    void assign(const string& name, Column col) {
+        if (!columns.empty() && col.data.size() != nrows()) {
+            throw invalid_argument("Invalid argument: column length does not match the DataFrame");
+        }
+        col.name = name;
+        if (col_data.count(name)) {
+            col_data.at(name) = make_shared<Column>(std::move(col));
+        } else {
+            append_column(std::move(col));
+        }
+    }
+
+    /**
+     * @brief Computes the pairwise Pearson correlation of all numeric columns.
+     *
+     * @return A DataFrame whose "column" column names each row, followed by one column per numeric column
+     * @note Missing values are excluded pairwise; pairs with fewer than two shared values or zero variance are missing
+     */
+    DataFrame corr() const {
+        return pairwise_moments(true);
+    }
+
+    /**
+     * @brief Computes the pairwise sample covariance (ddof = 1) of all numeric columns.
+     *
+     * @return A DataFrame whose "column" column names each row, followed by one column per numeric column
+     * @note Missing values are excluded pairwise; pairs with fewer than two shared values are missing
+     */
+    DataFrame cov() const {
+        return pairwise_moments(false);
+    }
+
+    /**
+     * @brief Saves the DataFrame to a CSV file with customizable options.
+     *
+     * This function allows saving the DataFrame to a specified file with various options:
+     * - Custom separator for columns.
+     * - Option to include or exclude column headers.
+     * - Option to include or exclude row indices.
+     * - Replace missing values with a custom string.
+     * - Save only specific columns if specified.
+     * - Fields containing the separator, a double quote or a line break are quoted, so the file loads back unchanged.
+     *
+     * @param output_file The path to the output file where the DataFrame will be saved.
+     * @param index Whether to include row indices in the output file (default: true).
+     * @param sep The separator to use between columns (default: ",").
+     * @param header Whether to include column headers in the output file (default: true).
+     * @param na_rep The string to replace missing values (default: "").
+     * @param selected_columns A vector of column names to save. If empty, all columns are saved (default: {}).
+     * @param compression "gzip", "zstd", "none", or "infer" to choose from the extension (.gz, .zst) (default: "infer").
+     * @throws std::runtime_error If the file cannot be opened for writing, or the compression is not enabled.
+     * @throws std::invalid_argument If the compression is not recognized.
+     * @throws std::out_of_range If any of the specified columns in `selected_columns` do not exist.
+     */
+    void save_to_csv(
+        const string& output_file,
+        bool index = true,
+        const string& sep = ",",
+        bool header = true,
+        const string& na_rep = "",
+        const vector <string>& selected_columns = {},
+        const string& compression = "infer"
+    ) const {
+        string codec = compression == "infer" ? compression_from_extension(output_file) : compression;
+        if (codec != "none" && codec != "gzip" && codec != "zstd") {
+           throw invalid_argument("Invalid argument: unknown compression `" + compression + "`");
+        }
+
+        std::filesystem::path file_path(output_file);
+ 
+        // Create directories if they don't exist
+        if (!file_path.parent_path().empty()) {
+           std::filesystem::create_directories(file_path.parent_path());
+        }
+        ofstream raw(output_file, ios::binary);
+ 
+        if (!raw) {
+           throw runtime_error("Error: Unable to open file for writing!");
+        }
+
+        unique_ptr<CompressedWriteBuf> compressed;
+        if (codec != "none") {
+           compressed = make_unique<CompressedWriteBuf>(make_encoder(codec, raw));
+        }
+        ostream file(compressed ? static_cast<streambuf*>(compressed.get()) : raw.rdbuf());
+ 
+        // Determine which columns to save
+        vector < string > columns_to_save;
+        if (selected_columns.empty()) {
+           columns_to_save = columns;
+        } else {
+           // Validate selected columns
+           for (const string & col_name: selected_columns) {
+              if (col_data.find(col_name) == col_data.end()) {
+                 throw std::out_of_range("Column not found: " + col_name);
+              }
+              columns_to_save.push_back(col_name);
+           }
+        }
+ 
+        // handle header option
+        if (header) {
+           // index option
+           if (index) {
+              file << "index" << sep;
+           }
+           for (size_t i = 0; i < columns_to_save.size(); ++i) {
+              write_csv_field(file, columns_to_save[i], sep);
+              if (i < columns_to_save.size() - 1) {
+                 file << sep;
+              }
+           }
+           file << '\n';
+        }
+ 
+        // Determine the number of rows
+        size_t num_rows = 0;
+        if (!columns_to_save.empty()) {
+           const string & first_col = columns_to_save[0];
+           num_rows = col_data.at(first_col)->data.size();
+         }
+ 
+        // Write row data
+        for (size_t idx = 0; idx < num_rows; ++idx) {
+           if (index) {
+              file << idx << sep;
+           }
+ 
+           for (size_t j = 0; j < columns_to_save.size(); ++j) {
+              const string & col_name = columns_to_save[j];
+              const auto & col = *col_data.at(col_name);
+ 
+              // Replace missing values with `na_rep` string
+              write_csv_field(file, col.data[idx].empty() ? na_rep : col.data[idx], sep);
+ 
+              if (j < columns_to_save.size() - 1) {
+                 file << sep;
+              }
+           }
+           file << '\n';
+        }
+ 
+        file.flush();
+        if (compressed) {
+           compressed->close();
+        }
+        raw.close();
+        cout << "Data saved successfully to " << output_file << " with separator '" << sep << "'." << endl;
+     }
+
+    friend std::ostream& operator<<(std::ostream& os, const DataFrame& df);
+
+    /**
+     * @brief Filters the DataFrame using a boolean mask.
+     * 
+     * @param mask Vector of boolean values indicating which rows to include
+     * @return A new filtered DataFrame
+     * @throws std::out_of_range If the mask size doesn't match the number of data rows
+     * @note Creates a new DataFrame with only the rows where mask is true
+     * @note The header row is always preserved
+     */
+    DataFrame operator[](const vector<bool> & mask) const {
+        return (*this)[Mask(mask)];
+    }
+
+    /**
+     * @brief Filters the DataFrame using a packed row mask.
+     * 
+     * @param mask Mask indicating which rows to include, e.g. `(df["a"] > 1) & (df["b"] < 2)`
+     * @return A new filtered DataFrame
+     * @throws std::out_of_range If the mask size doesn't match the number of data rows
+     * @note Output columns are sized from the mask's popcount up front and filled in parallel
+     */
+    DataFrame operator[](const Mask& mask) const {
+        if (mask.size() != nrows()) {
+            throw std::out_of_range("Mask size does not match data rows!");
+        }
+
+        DataFrame filtered_df;
+        filtered_df.file_dir = file_dir;
+        filtered_df.columns = columns;
+
+        vector<const Column*> sources;
+        vector<Column*> targets;
+        for (const auto& col_name : columns) {
+            const Column& source = *col_data.at(col_name);
+            Column& filtered_col = *(filtered_df.col_data[col_name] = make_shared<Column>());
+            filtered_col.name = col_name;
+            filtered_col.dtype = source.dtype;
+            sources.push_back(&source);
+            targets.push_back(&filtered_col);
+        }
+
+        size_t kept = mask.count();
+        parallel_for(targets.size(), [&](size_t c) {
+            const vector<string>& cells = sources[c]->data;
+            vector<string> filtered;
+            filtered.reserve(kept);
+            mask.for_each_set([&](size_t i) { filtered.push_back(cells[i]); });
+            targets[c]->data = std::move(filtered);
+        });
+
+        return filtered_df;
+    }
+
+    /**
+     * @brief Accesses a single column by name.
+     * 
+     * @param key The name of the column to access
+     * @return Reference to the Column object
+     * @throws std::out_of_range If the column name is not found
+     */
+    Column& operator[](const string& key) {
+        auto it = col_data.find(key);
+        if (it != col_data.end()) {
+            return write_column(it->second);
+        }
+        throw std::out_of_range("Column not found!");
+    }
+
+    const Column& operator[](const string& key) const {
+        auto it = col_data.find(key);
+        if (it != col_data.end()) {
+            return *it->second;
+        }
+        throw std::out_of_range("Column not found!");
+    }
+
+    /**
+     * @brief Displays specific columns of the DataFrame.
+     * 
+     * @param keys Vector of column names to display
+     * @return A dummy Column object (for interface compatibility)
+     * @note This method prints the specified columns and returns a dummy Column
+     */
+    Column operator[](const vector<string>& keys) {
+        print(0, 0, keys);
+
+        Column dummy;
+        return dummy;
+    }
+};
+
+ostream& operator<<(std::ostream& os, const DataFrame& df) {
+    df.print();
+    return os;
+}
+
+ostream& operator<<(std::ostream& os, const Column& col) {
+    col.print();
+    return os;
+}
+
+/**
+ * @brief A DataFrame shared between reader threads and writers, with snapshot isolation.
+ *
+ * Readers call snapshot() to pin the current version: an immutable DataFrame that stays valid and
+ * unchanged for as long as they hold it, whatever writers do meanwhile. Writers call update(), which
+ * runs on a working copy that shares every column with the current version; a column is copied only
+ * when the update modifies it. The finished version is published by swapping an atomic shared_ptr.
+ * That swap is not lock-free (libstdc++ guards it with a short internal lock), but readers only contend
+ * for the pointer copy itself, never for the duration of an update. Old versions are freed by the last
+ * reader to drop them.
+ *
+ * Usage:
+ *     SharedFrame shared(DataFrame("data.csv"));
+ *     // reader threads
+ *     auto df = shared.snapshot();
+ *     DataFrame adults = (*df)[(*df)["Age"] >= 18];
+ *     // writer thread
+ *     shared.update([](DataFrame& df) { df.dropna("Age"); });
+ *
+ * @note Readers must only use const methods of a snapshot
+ */
+class SharedFrame {
+private:
+#if defined(__cpp_lib_atomic_shared_ptr)
+    atomic<shared_ptr<const DataFrame>> current;
+#else
+    shared_ptr<const DataFrame> current; // only accessed through atomic_load / atomic_store
+#endif
+    atomic<uint64_t> current_version{0};
+    mutex writer; // serializes updates; never taken by readers
+
+    /**
+     * @brief Brings the cached statistics of every column up to date, so that readers never write to them.
+     */
+    static void freeze(const DataFrame& df) {
+        for (const auto& entry : df.col_data) {
+            entry.second->stats();
+        }
+    }
+
+    void publish(shared_ptr<const DataFrame> next) {
+#if defined(__cpp_lib_atomic_shared_ptr)
+        current.store(std::move(next));
+#else
+        atomic_store(&current, std::move(next));
+#endif
+    }
+
+public:
+    /**
+     * @brief Publishes `df` as the first version.
+     */
+    explicit SharedFrame(DataFrame df) {
+        freeze(df);
+        publish(make_shared<const DataFrame>(std::move(df)));
+    }
+
+    /**
+     * @brief Pins the current version.
+     * 
+     * @return An immutable DataFrame, unaffected by later updates
+     * @note Takes only a short internal lock for the pointer copy; it never waits for an update in progress
+     */
+    shared_ptr<const DataFrame> snapshot() const {
+#if defined(__cpp_lib_atomic_shared_ptr)
+        return current.load();
+#else
+        return atomic_load(&current);
+#endif
+    }
+
+    /**
+     * @brief Returns the number of updates published so far.
+     */
+    uint64_t version() const {
+        return current_version.load();
+    }
+
+    /**
+     * @brief Applies a change and publishes the result as a new version.
+     * 
+     * @param fn Called with a working copy of the current version, e.g. `[](DataFrame& df) { df.fillna(0); }`
+     * @return The new version number
+     * @note Columns that `fn` does not modify are shared with the previous version, not copied
+     * @note If `fn` throws, nothing is published and the exception propagates
+     */
+    template <typename Fn>
+    uint64_t update(Fn fn) {
+        lock_guard<mutex> lock(writer);
+        shared_ptr<const DataFrame> base = snapshot();
+
+        DataFrame next;
+        next.col_data = base->col_data;
+        next.file_dir = base->file_dir;
+        next.columns = base->columns;
+        base.reset();
+
+        fn(next);
+        freeze(next);
+        publish(make_shared<const DataFrame>(std::move(next)));
+        return ++current_version;
+    }
+};
+
+#if defined(__unix__) || defined(__APPLE__)
+class OutOfCoreFrame;
+
+/**
+ * @brief A column of an OutOfCoreFrame, returned by OutOfCoreFrame::operator[].
+ *
+ * Mirrors the Column comparisons and reductions: comparisons stream over the column's
+ * segments one block at a time, and reductions are served from statistics gathered while loading.
+ */
+class OutOfCoreColumn {
+private:
+    const OutOfCoreFrame* frame;
+    size_t index;
+
+public:
+    OutOfCoreColumn(const OutOfCoreFrame& owner, size_t col_index) : frame(&owner), index(col_index) {}
+
+    const string& name() const;
+    const string& dtype() const;
+
+    double sum() const;
+    double mean() const;
+    double min() const;
+    double max() const;
+
+    Mask operator==(double key) const;
+    Mask operator!=(double key) const;
+    Mask operator<(double key) const;
+    Mask operator>(double key) const;
+    Mask operator<=(double key) const;
+    Mask operator>=(double key) const;
+
+    Mask operator==(const string& key) const;
+    Mask operator!=(const string& key) const;
+    Mask operator<(const string& key) const;
+    Mask operator>(const string& key) const;
+    Mask operator<=(const string& key) const;
+    Mask operator>=(const string& key) const;
+};
+
+/**
+ * @brief A CSV-backed table that keeps its columns on disk, for data larger than memory.
+ *
+ * The file is read in batches whose size is bounded by the memory budget. Each batch is spilled
+ * to one segment file per column in a scratch directory, and dtypes, statistics and per-block
+ * zone maps are gathered on the way. Queries then memory-map one block of a column at a time:
+ * filters skip blocks using the zone maps, and select() and save_to_csv() stream the selected
+ * rows block by block. Results match those of the in-memory DataFrame on the same file.
+ *
+ * Usage:
+ *     OutOfCoreFrame big("huge.csv", 256 << 20); // 256 MiB budget
+ *     Mask expensive = big["price"] > 1000.0;
+ *     big.save_to_csv("expensive.csv", false, ",", true, "", {}, "infer", expensive);
+ *     double avg = big["price"].mean();
+ *
+ * @note Segment files are deleted when the frame is destroyed
+ * @note Available on POSIX systems
+ */
+class OutOfCoreFrame {
+private:
+    friend class OutOfCoreColumn;
+
+    struct SegmentBlock {
+        size_t file_offset = 0; // start of the block in the segment file
+        size_t bytes = 0;       // (rows + 1) uint64 cell offsets, then the cell bytes, padded to 8 bytes
+        ZoneMap zone;           // numeric statistics of the block, for skipping it in filters
+    };
+
+    struct SpilledColumn {
+        string name;
+        string dtype = "int"; // dtype of the whole column, as infer_dtype() would give for all of its cells
+        bool typed = false;   // whether a non-missing cell has been seen
+        ColumnStats stats;    // numeric statistics, accumulated in row order
+        string path;
+        ofstream writer;      // open while loading; each batch appends a block
+        size_t file_size = 0;
+        int fd = -1;
+        vector<SegmentBlock> blocks;
+    };
+
+    vector<SpilledColumn> spilled;
+    vector<size_t> block_starts; // first row of each block; blocks are aligned across columns
+    size_t rows = 0;
+    size_t memory_budget;
+    std::filesystem::path scratch; // this frame's own directory inside the scratch directory
+
+    /**
+     * @brief Appends the rows of a batch to the segment files and clears the batch.
+     */
+    void spill(DataFrame& batch) {
+        if (spilled.empty()) {
+            spilled.resize(batch.columns.size());
+            for (size_t j = 0; j < spilled.size(); j++) {
+                spilled[j].name = batch.columns[j];
+                spilled[j].path = (scratch / (to_string(j) + ".seg")).string();
+                spilled[j].writer.open(spilled[j].path, ios::binary);
+                if (!spilled[j].writer) {
+                    throw runtime_error("Error: Unable to write spill file " + spilled[j].path);
+                }
+            }
+        }
+        block_starts.push_back(rows);
+        rows += batch.nrows();
+
+        parallel_for(spilled.size(), [&](size_t j) {
+            SpilledColumn& sc = spilled[j];
+            Column& col = batch.write_column(batch.columns[j]);
+            const vector<string>& cells = col.data;
+
+            if (std::any_of(cells.begin(), cells.end(), [](const string& cell) { return !cell.empty(); })) {
+                sc.dtype = sc.typed ? Column::wider_dtype(sc.dtype, col.dtype) : col.dtype;
+                sc.typed = true;
+            }
+
+            SegmentBlock block;
+            block.file_offset = sc.file_size;
+            vector<uint64_t> offsets(cells.size() + 1, 0);
+            double num;
+            for (size_t i = 0; i < cells.size(); i++) {
+                offsets[i + 1] = offsets[i] + cells[i].size();
+                if (parse_number(cells[i], num)) {
+                    block.zone.add(num);
+                    sc.stats.count++;
+                    sc.stats.sum += num;
+                    sc.stats.min = std::min(sc.stats.min, num);
+                    sc.stats.max = std::max(sc.stats.max, num);
+                } else {
+                    block.zone.add_null();
+                    sc.stats.null_count++;
+                }
+            }
+
+            ofstream& out = sc.writer;
+            out.write(reinterpret_cast<const char*>(offsets.data()), offsets.size() * sizeof(uint64_t));
+            for (const string& cell : cells) {
+                out.write(cell.data(), cell.size());
+            }
+            size_t bytes = offsets.size() * sizeof(uint64_t) + offsets.back();
+            size_t padding = (8 - bytes % 8) % 8;
+            out.write("\0\0\0\0\0\0\0", padding);
+            if (!out) {
+                throw runtime_error("Error: Unable to write spill file " + sc.path);
+            }
+
+            block.bytes = bytes + padding;
+            sc.file_size += block.bytes;
+            sc.blocks.push_back(block);
+            col.data.clear();
+        });
+    }
+
+    /**
+     * @brief Memory-maps one block of a column and copies it into a Column with the column's dtype.
+     */
+    Column load_block(size_t j, size_t b) const {
+        const SpilledColumn& sc = spilled[j];
+        const SegmentBlock& block = sc.blocks[b];
+        size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        size_t aligned = block.file_offset / page * page;
+        size_t length = block.file_offset - aligned + block.bytes;
+
+        void* addr = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, sc.fd, aligned);
+        if (addr == MAP_FAILED) {
+            throw runtime_error("Error: Unable to map spill file " + sc.path);
         }
+        const char* base = static_cast<const char*>(addr) + (block.file_offset - aligned);
+        const uint64_t* offsets = reinterpret_cast<const uint64_t*>(base);
+        const char* chars = base + (block.zone.rows + 1) * sizeof(uint64_t);
 
-        if (cols.size() == 0) {
-            cols = columns;
+        vector<string> cells(block.zone.rows);
+        for (size_t i = 0; i < cells.size(); i++) {
+            cells[i].assign(chars + offsets[i], offsets[i + 1] - offsets[i]);
         }
+        munmap(addr, length);
 
-        vector<vector<string>> print_row_data;
-        vector<string> col_name_row;
-        size_t sz = 0;
-        for(string col : cols) {
-            bool found = false;
-            for (auto it = col_data.rbegin(); it != col_data.rend(); ++it) {
-                if (col == it->second.name) {
-                    col_name_row.push_back(it->second.name);
-                    sz = it->second.data.size();
-                    found = true;
-                    break;
+        Column col;
+        col.name = sc.name;
+        col.dtype = sc.dtype;
+        col.data = std::move(cells);
+        return col;
+    }
+
+    /**
+     * @brief Returns the index of a column.
+     *
+     * @throws std::out_of_range If the column is not found
+     */
+    size_t column_index(const string& col_name) const {
+        for (size_t j = 0; j < spilled.size(); j++) {
+            if (spilled[j].name == col_name) {
+                return j;
+            }
+        }
+        throw std::out_of_range("Column not found: " + col_name);
+    }
+
+    /**
+     * @brief Evaluates a comparison block by block, skipping numeric blocks that its zone map decides.
+     *
+     * @param compare Applies the comparison to a loaded block, as the in-memory Column would
+     * @param none_match Returns true if no value in a block with this zone map can match (numeric keys only)
+     * @param all_match Returns true if every value in a block without missing cells matches (numeric keys only)
+     */
+    template <typename Compare, typename NoneMatch, typename AllMatch>
+    Mask compare_blocks(size_t j, bool numeric_key, Compare compare, NoneMatch none_match, AllMatch all_match) const {
+        const SpilledColumn& sc = spilled[j];
+        bool numeric = sc.dtype == "int" || sc.dtype == "float";
+        if (numeric != numeric_key) {
+            throw runtime_error("Error: Invalid comparison");
+        }
+
+        Mask mask(rows);
+        for (size_t b = 0; b < sc.blocks.size(); b++) {
+            const ZoneMap& zone = sc.blocks[b].zone;
+            size_t start = block_starts[b];
+            if (numeric) {
+                if (zone.null_count == zone.rows || none_match(zone)) {
+                    continue;
+                }
+                if (zone.null_count == 0 && all_match(zone)) {
+                    mask.set_range(start, start + zone.rows);
+                    continue;
                 }
             }
+            Mask part = compare(load_block(j, b));
+            part.for_each_set([&](size_t i) { mask.set(start + i); });
+        }
+        return mask;
+    }
 
-            if (!found) {
-                throw std::out_of_range("Column not found!");
+    /**
+     * @brief Closes the segment files and deletes the scratch directory.
+     */
+    void cleanup() {
+        for (SpilledColumn& sc : spilled) {
+            if (sc.writer.is_open()) {
+                sc.writer.close();
+            }
+            if (sc.fd >= 0) {
+                close(sc.fd);
+                sc.fd = -1;
             }
         }
-        print_row_data.push_back(col_name_row);
+        std::error_code ec;
+        std::filesystem::remove_all(scratch, ec);
+    }
 
-        for(size_t idx = 0; idx < sz; idx++) {
-            vector<string> new_row;
-            for(string col : cols) {
-                for (auto it = col_data.rbegin(); it != col_data.rend(); ++it) {
-                    if (col == it->second.name) {
-                        new_row.push_back(it->second.data[idx]);
-                        break;
+public:
+    vector<string> columns;
+
+    /**
+     * @brief Loads a CSV file into segment files, keeping at most about `memory_budget` bytes of rows in memory.
+     * 
+     * @param path Path to the CSV file (gzip and zstd files are detected as for DataFrame)
+     * @param memory_budget Memory allowed for buffered rows while loading and for blocks while querying, in bytes
+     * @param scratch_dir Directory for the segment files (default: the system's temporary directory)
+     * @param options Read options, as for DataFrame
+     * @throws invalid_argument If `memory_budget` is 0
+     * @throws runtime_error If the file cannot be read or the segment files cannot be written
+     * @note Each batch uses about a quarter of the budget (but holds at least 1024 rows), leaving room
+     *       for the block being spilled
+     */
+    OutOfCoreFrame(const string& path, size_t memory_budget, const string& scratch_dir = "",
+                   const CsvOptions& options = CsvOptions())
+    : memory_budget(memory_budget) {
+        if (memory_budget == 0) {
+            throw invalid_argument("Invalid argument: OutOfCoreFrame expects a positive `memory_budget`");
+        }
+        static atomic<uint64_t> frame_counter{0};
+        std::filesystem::path parent = scratch_dir.empty() ? std::filesystem::temp_directory_path()
+                                                           : std::filesystem::path(scratch_dir);
+        scratch = parent / ("lesser_pandas_" + to_string(getpid()) + "_" + to_string(frame_counter++));
+        std::filesystem::create_directories(scratch);
+
+        try {
+            DataFrame batch;
+            batch.read_csv(path, 0, true, options, memory_budget / 4, [&]() { spill(batch); });
+            columns = batch.columns;
+            if (spilled.empty()) {
+                spill(batch);
+            }
+            for (SpilledColumn& sc : spilled) {
+                sc.writer.close();
+                if (!sc.writer) {
+                    throw runtime_error("Error: Unable to write spill file " + sc.path);
+                }
+                sc.fd = open(sc.path.c_str(), O_RDONLY);
+                if (sc.fd < 0) {
+                    throw runtime_error("Error: Unable to open spill file " + sc.path);
+                }
+            }
+        } catch (...) {
+            cleanup();
+            throw;
+        }
+    }
+
+    OutOfCoreFrame(const OutOfCoreFrame&) = delete;
+    OutOfCoreFrame& operator=(const OutOfCoreFrame&) = delete;
+
+    ~OutOfCoreFrame() {
+        cleanup();
+    }
+
+    /**
+     * @brief Returns the number of data rows (excluding the header).
+     */
+    size_t nrows() const {
+        return rows;
+    }
+
+    /**
+     * @brief Returns the configured memory budget in bytes.
+     */
+    size_t budget() const {
+        return memory_budget;
+    }
+
+    /**
+     * @brief Accesses a single column by name.
+     * 
+     * @throws std::out_of_range If the column name is not found
+     */
+    OutOfCoreColumn operator[](const string& key) const {
+        return OutOfCoreColumn(*this, column_index(key));
+    }
+
+    /**
+     * @brief Copies the rows selected by a mask into an in-memory DataFrame.
+     * 
+     * @param mask Mask indicating which rows to include (empty = all rows)
+     * @param selected_columns Columns to copy (empty = all columns)
+     * @return The same DataFrame as filtering the in-memory DataFrame, restricted to `selected_columns`
+     * @throws std::out_of_range If the mask size doesn't match the number of rows, or a column is not found
+     */
+    DataFrame select(const Mask& mask = Mask(), const vector<string>& selected_columns = {}) const {
+        if (mask.size() != 0 && mask.size() != rows) {
+            throw std::out_of_range("Mask size does not match data rows!");
+        }
+        vector<size_t> picked;
+        for (const string& col_name : selected_columns.empty() ? columns : selected_columns) {
+            picked.push_back(column_index(col_name));
+        }
+
+        vector<vector<string>> cells(picked.size());
+        for (size_t b = 0; b < block_starts.size(); b++) {
+            for (size_t c = 0; c < picked.size(); c++) {
+                vector<string> block = load_block(picked[c], b).data.release();
+                for (size_t i = 0; i < block.size(); i++) {
+                    if (mask.size() == 0 || mask[block_starts[b] + i]) {
+                        cells[c].push_back(std::move(block[i]));
                     }
                 }
             }
-            print_row_data.push_back(new_row);
         }
 
-        size_t idx = 0;
-        for(auto& row : print_row_data) {
-            cout << std::left;
-            if (is_tail && idx < static_cast<size_t>(row_data.size()-rows_cnt)) {
-                if (idx == 0) {
-                    for(auto& element : row) {
-                        cout << setw(20) << element;
-                    }
-                    cout << endl;
-                }
-                idx++;
-                continue;
-            }
-            for(auto& element : row) {
-                cout << setw(20) << element;
-            }
-            cout << endl;
-            idx++;
-            if (idx == static_cast<size_t>(rows_cnt + 1) && !is_tail) {
-                break;
-            }
+        DataFrame df;
+        for (size_t c = 0; c < picked.size(); c++) {
+            Column col;
+            col.name = spilled[picked[c]].name;
+            col.dtype = spilled[picked[c]].dtype;
+            col.data = std::move(cells[c]);
+            col.build_statistics();
+            df.append_column(std::move(col));
+        }
+        return df;
+    }
+
+    /**
+     * @brief Saves the rows selected by a mask to a CSV file, streaming one block at a time.
+     * 
+     * The parameters match DataFrame::save_to_csv(), and the output is identical to saving
+     * the filtered in-memory DataFrame.
+     * 
+     * @param mask Mask indicating which rows to save (empty = all rows)
+     * @throws std::runtime_error If the file cannot be opened for writing, or the compression is not enabled.
+     * @throws std::invalid_argument If the compression is not recognized.
+     * @throws std::out_of_range If a column in `selected_columns` does not exist, or the mask size doesn't match.
+     */
+    void save_to_csv(
+        const string& output_file,
+        bool index = true,
+        const string& sep = ",",
+        bool header = true,
+        const string& na_rep = "",
+        const vector <string>& selected_columns = {},
+        const string& compression = "infer",
+        const Mask& mask = Mask()
+    ) const {
+        string codec = compression == "infer" ? compression_from_extension(output_file) : compression;
+        if (codec != "none" && codec != "gzip" && codec != "zstd") {
+           throw invalid_argument("Invalid argument: unknown compression `" + compression + "`");
+        }
+        if (mask.size() != 0 && mask.size() != rows) {
+           throw std::out_of_range("Mask size does not match data rows!");
+        }
+        vector<size_t> picked;
+        for (const string& col_name : selected_columns.empty() ? columns : selected_columns) {
+           picked.push_back(column_index(col_name));
+        }
+
+        std::filesystem::path file_path(output_file);
+        if (!file_path.parent_path().empty()) {
+           std::filesystem::create_directories(file_path.parent_path());
+        }
+        ofstream raw(output_file, ios::binary);
+        if (!raw) {
+           throw runtime_error("Error: Unable to open file for writing!");
+        }
+
+        unique_ptr<CompressedWriteBuf> compressed;
+        if (codec != "none") {
+           compressed = make_unique<CompressedWriteBuf>(make_encoder(codec, raw));
+        }
+        ostream file(compressed ? static_cast<streambuf*>(compressed.get()) : raw.rdbuf());
+
+        if (header) {
+           if (index) {
+              file << "index" << sep;
+           }
+           for (size_t c = 0; c < picked.size(); ++c) {
+              write_csv_field(file, spilled[picked[c]].name, sep);
+              if (c < picked.size() - 1) {
+                 file << sep;
+              }
+           }
+           file << '\n';
+        }
+
+        size_t written = 0;
+        vector<Column> block(picked.size());
+        for (size_t b = 0; b < block_starts.size(); b++) {
+           for (size_t c = 0; c < picked.size(); c++) {
+              block[c] = load_block(picked[c], b);
+           }
+           size_t block_rows = spilled[picked.empty() ? 0 : picked[0]].blocks[b].zone.rows;
+           for (size_t i = 0; i < block_rows && !picked.empty(); i++) {
+              if (mask.size() != 0 && !mask[block_starts[b] + i]) {
+                 continue;
+              }
+              if (index) {
+                 file << written << sep;
+              }
+              for (size_t c = 0; c < picked.size(); ++c) {
+                 const string& value = block[c].data[i];
+                 write_csv_field(file, value.empty() ? na_rep : value, sep);
+                 if (c < picked.size() - 1) {
+                    file << sep;
+                 }
+              }
+              file << '\n';
+              written++;
+           }
+        }
+
+        file.flush();
+        if (compressed) {
+           compressed->close();
+        }
+        raw.close();
+        cout << "Data saved successfully to " << output_file << " with separator '" << sep << "'." << endl;
+    }
+};
+
+const string& OutOfCoreColumn::name() const {
+    return frame->spilled[index].name;
+}
+
+const string& OutOfCoreColumn::dtype() const {
+    return frame->spilled[index].dtype;
+}
+
+double OutOfCoreColumn::sum() const {
+    if (dtype() != "int" && dtype() != "float") {
+        throw invalid_argument("Invalid type: OutOfCoreColumn::sum() expects `dtype` to be int or float");
+    }
+    return frame->spilled[index].stats.sum;
+}
+
+double OutOfCoreColumn::mean() const {
+    if (dtype() != "int" && dtype() != "float") {
+        throw invalid_argument("Invalid type: OutOfCoreColumn::mean() expects `dtype` to be int or float");
+    }
+    const ColumnStats& st = frame->spilled[index].stats;
+    return st.sum / static_cast<double>(st.count);
+}
+
+double OutOfCoreColumn::min() const {
+    if (dtype() != "int" && dtype() != "float") {
+        throw invalid_argument("Invalid type: OutOfCoreColumn::min() expects `dtype` to be int or float");
+    }
+    const ColumnStats& st = frame->spilled[index].stats;
+    return st.count == 0 ? numeric_limits<double>::quiet_NaN() : st.min;
+}
+
+double OutOfCoreColumn::max() const {
+    if (dtype() != "int" && dtype() != "float") {
+        throw invalid_argument("Invalid type: OutOfCoreColumn::max() expects `dtype` to be int or float");
+    }
+    const ColumnStats& st = frame->spilled[index].stats;
+    return st.count == 0 ? numeric_limits<double>::quiet_NaN() : st.max;
+}
+
+Mask OutOfCoreColumn::operator==(double key) const {
+    return frame->compare_blocks(index, true,
+        [&](const Column& col) { return col == key; },
+        [&](const ZoneMap& zone) { return zone.min > key || zone.max < key; },
+        [&](const ZoneMap& zone) { return zone.min == key && zone.max == key; });
+}
+
+Mask OutOfCoreColumn::operator!=(double key) const {
+    return frame->compare_blocks(index, true,
+        [&](const Column& col) { return col != key; },
+        [&](const ZoneMap& zone) { return zone.min == key && zone.max == key; },
+        [&](const ZoneMap& zone) { return zone.min > key || zone.max < key; });
+}
+
+Mask OutOfCoreColumn::operator<(double key) const {
+    return frame->compare_blocks(index, true,
+        [&](const Column& col) { return col < key; },
+        [&](const ZoneMap& zone) { return zone.min >= key; },
+        [&](const ZoneMap& zone) { return zone.max < key; });
+}
+
+Mask OutOfCoreColumn::operator>(double key) const {
+    return frame->compare_blocks(index, true,
+        [&](const Column& col) { return col > key; },
+        [&](const ZoneMap& zone) { return zone.max <= key; },
+        [&](const ZoneMap& zone) { return zone.min > key; });
+}
+
+Mask OutOfCoreColumn::operator<=(double key) const {
+    return frame->compare_blocks(index, true,
+        [&](const Column& col) { return col <= key; },
+        [&](const ZoneMap& zone) { return zone.min > key; },
+        [&](const ZoneMap& zone) { return zone.max <= key; });
+}
+
+Mask OutOfCoreColumn::operator>=(double key) const {
+    return frame->compare_blocks(index, true,
+        [&](const Column& col) { return col >= key; },
+        [&](const ZoneMap& zone) { return zone.max < key; },
+        [&](const ZoneMap& zone) { return zone.min >= key; });
+}
+
+// string and datetime columns have no numeric zone maps, so every block is loaded
+Mask OutOfCoreColumn::operator==(const string& key) const {
+    return frame->compare_blocks(index, false,
+        [&](const Column& col) { return col == key; },
+        [](const ZoneMap&) { return false; },
+        [](const ZoneMap&) { return false; });
+}
+
+Mask OutOfCoreColumn::operator!=(const string& key) const {
+    return frame->compare_blocks(index, false,
+        [&](const Column& col) { return col != key; },
+        [](const ZoneMap&) { return false; },
+        [](const ZoneMap&) { return false; });
+}
+
+Mask OutOfCoreColumn::operator<(const string& key) const {
+    return frame->compare_blocks(index, false,
+        [&](const Column& col) { return col < key; },
+        [](const ZoneMap&) { return false; },
+        [](const ZoneMap&) { return false; });
+}
+
+Mask OutOfCoreColumn::operator>(const string& key) const {
+    return frame->compare_blocks(index, false,
+        [&](const Column& col) { return col > key; },
+        [](const ZoneMap&) { return false; },
+        [](const ZoneMap&) { return false; });
+}
+
+Mask OutOfCoreColumn::operator<=(const string& key) const {
+    return frame->compare_blocks(index, false,
+        [&](const Column& col) { return col <= key; },
+        [](const ZoneMap&) { return false; },
+        [](const ZoneMap&) { return false; });
+}
+
+Mask OutOfCoreColumn::operator>=(const string& key) const {
+    return frame->compare_blocks(index, false,
+        [&](const Column& col) { return col >= key; },
+        [](const ZoneMap&) { return false; },
+        [](const ZoneMap&) { return false; });
+}
+#endif
+
+#if __cplusplus >= 202002L
+
+/**
+ * @brief A string literal usable as a template argument, e.g. the name in `Col<"price", double>`.
+ */
+template <size_t N>
+struct FixedString {
+    char value[N];
+
+    constexpr FixedString(const char (&str)[N]) {
+        std::copy(str, str + N, value);
+    }
+
+    constexpr string_view view() const {
+        return string_view(value, N - 1);
+    }
+};
+
+/**
+ * @brief Declares a column of a TypedFrame: its name and C++ type.
+ * 
+ * Supported types are `double` (missing cells become NaN), integral types, `string`, and
+ * `optional<T>` of those for columns that may contain missing cells.
+ */
+template <FixedString Name, typename T>
+struct Col {
+    using type = T;
+    static constexpr FixedString name = Name;
+};
+
+/**
+ * @brief A list of Col declarations, used as the template argument of TypedFrame.
+ */
+template <typename... Cols>
+struct Schema {};
+
+/**
+ * @brief Converts CSV cells to and from a schema type. Parsing fails on cells that do not fit the type.
+ */
+template <typename T>
+struct CellTraits {
+    // bool has no CSV dtype (and no from_chars overload), so it is rejected here rather than deep in parse()
+    static_assert((is_integral_v<T> && !is_same_v<T, bool>) || is_floating_point_v<T>,
+                  "Unsupported TypedFrame column type");
+
+    static bool parse(const string& cell, T& out) {
+        if constexpr (is_floating_point_v<T>) {
+            double num;
+            out = parse_number(cell, num) ? static_cast<T>(num) : numeric_limits<T>::quiet_NaN();
+            return cell.empty() || out == out;
+        } else {
+            // the grammar infer_dtype() accepts for "int" columns
+            return parse_integer(cell, out);
+        }
+    }
+
+    static bool missing(const T& value) {
+        if constexpr (is_floating_point_v<T>) {
+            return value != value;
+        } else {
+            return false;
+        }
+    }
+
+    static string format(const T& value) {
+        if constexpr (is_floating_point_v<T>) {
+            return format_number(value);
+        } else {
+            return to_string(value);
+        }
+    }
+
+    static string dtype() {
+        return is_floating_point_v<T> ? "float" : "int";
+    }
+};
+
+template <>
+struct CellTraits<string> {
+    static bool parse(const string& cell, string& out) {
+        out = cell;
+        return true;
+    }
+
+    static bool missing(const string& value) {
+        return value.empty();
+    }
+
+    static string format(const string& value) {
+        return value;
+    }
+
+    static string dtype() {
+        return "string";
+    }
+};
+
+template <typename T>
+struct CellTraits<optional<T>> {
+    static bool parse(const string& cell, optional<T>& out) {
+        if (cell.empty()) {
+            out.reset();
+            return true;
+        }
+        T value;
+        if (!CellTraits<T>::parse(cell, value)) {
+            return false;
+        }
+        out = std::move(value);
+        return true;
+    }
+
+    static bool missing(const optional<T>& value) {
+        return !value.has_value() || CellTraits<T>::missing(*value);
+    }
+
+    static string format(const optional<T>& value) {
+        return value ? CellTraits<T>::format(*value) : "";
+    }
+
+    static string dtype() {
+        return CellTraits<T>::dtype();
+    }
+};
+
+template <typename Schema>
+class TypedFrame;
+
+/**
+ * @brief A DataFrame whose column names and types are fixed at compile time.
+ * 
+ * Columns are stored as `vector<T>` of their declared types. Column access by name is resolved
+ * at compile time (an unknown name does not compile), and the kernels are instantiated per
+ * column type, so no dtype strings are compared at run time.
+ * 
+ * Usage:
+ *     using Sales = Schema<Col<"item", string>, Col<"price", double>, Col<"qty", optional<int64_t>>>;
+ *     TypedFrame<Sales> sales("sales.csv");
+ *     double revenue = sales.sum<"price">();
+ *     DataFrame df = sales.to_frame();
+ * 
+ * @note Requires C++20
+ */
+template <typename... Cols>
+class TypedFrame<Schema<Cols...>> {
+private:
+    tuple<vector<typename Cols::type>...> col_data;
+
+    static constexpr array<string_view, sizeof...(Cols)> names = {Cols::name.view()...};
+
+    template <size_t I>
+    using value_type = typename tuple_element_t<I, tuple<Cols...>>::type;
+
+    /**
+     * @brief Parses `cells` onto the end of the I-th column, or throws on the first cell that does not fit.
+     */
+    template <size_t I>
+    void append_cells(const vector<string>& cells) {
+        auto& values = std::get<I>(col_data);
+        size_t first = values.size();
+        values.resize(first + cells.size());
+        for (size_t i = 0; i < cells.size(); i++) {
+            if (!CellTraits<value_type<I>>::parse(cells[i], values[first + i])) {
+                throw runtime_error("Error: column `" + string(names[I]) + "` row " + to_string(first + i) + ": `"
+                                    + cells[i] + "` is not a valid " + CellTraits<value_type<I>>::dtype());
+            }
+        }
+    }
+
+    /**
+     * @brief Reads a CSV file straight into the typed columns, one batch of rows at a time.
+     */
+    template <size_t... I>
+    void read(const string& path, const CsvOptions& options, index_sequence<I...>) {
+        // the reader only tokenizes: it keeps no cells, infers no dtypes and builds no statistics
+        DataFrame reader;
+        reader.read_csv(path, 0, true, options, 0, nullptr, [&](const vector<vector<string>>& batch) {
+            const vector<string>& order = reader.columns; // file order
+            (append_cells<I>(batch[std::find(order.begin(), order.end(), names[I]) - order.begin()]), ...);
+        });
+    }
 
-            if (idx == row_data.size() && is_tail) {
-                break;
+    template <size_t... I>
+    void load(const DataFrame& df, index_sequence<I...>) {
+        (append_cells<I>(df[string(names[I])].data), ...);
+        if (((std::get<I>(col_data).size() != size()) || ...)) {
+            throw runtime_error("Error: columns have different lengths");
+        }
+    }
+
+public:
+    /**
+     * @brief Returns the index of a column in the schema, or the schema size if it is not there.
+     */
+    template <FixedString Name>
+    static constexpr size_t index_of() {
+        for (size_t i = 0; i < names.size(); i++) {
+            if (names[i] == Name.view()) {
+                return i;
             }
         }
-        cout << "\nPrinted: " << print_row_data.size() << " rows\n";
+        return names.size();
     }
 
     /**
-     * @brief Displays the first N rows of the DataFrame.
-     * 
-     * @param rows_cnt Number of rows to display from the beginning (default: 5)
+     * @brief Default constructor for creating an empty TypedFrame.
      */
-    void head(int rows_cnt = 5) const {
-        print(rows_cnt);
-    };
+    TypedFrame() = default;
 
     /**
-     * @brief Displays the last N rows of the DataFrame.
+     * @brief Loads the schema's columns from a CSV file and validates every cell against the declared types.
      * 
-     * @param rows_cnt Number of rows to display from the end (default: 5)
+     * @param path Path to the CSV file
+     * @param options Read options; `usecols` is replaced by the schema's columns
+     * @throws std::out_of_range If a schema column is not in the file
+     * @throws runtime_error If the file cannot be read, or a cell does not fit its column type
      */
-    void tail(int rows_cnt = 5) const {
-        print(rows_cnt, 1);
-    };
+    explicit TypedFrame(const string& path, CsvOptions options = CsvOptions()) {
+        options.usecols.assign(names.begin(), names.end());
+        read(path, options, index_sequence_for<Cols...>());
+    }
 
     /**
-     * @brief Renames columns in the DataFrame.
+     * @brief Converts a dynamic DataFrame, validating its columns against the schema.
      * 
-     * @param vec Vector of pairs containing (old_name, new_name) mappings
-     * @throws std::out_of_range If any old column name is not found
+     * @param df The DataFrame to convert; columns not in the schema are ignored
+     * @throws std::out_of_range If a schema column is not in the DataFrame
+     * @throws runtime_error If a cell does not fit its column type
      */
-    void rename(vector<pair<string, string>> vec) {
-        for(pair<string, string> col_pair : vec) {
-            string old_col_name = col_pair.first;
-            string new_col_name = col_pair.second;
-
-            auto it = col_data.find(old_col_name);
-            if (it != col_data.end()) {
-                col_data[new_col_name] = it->second;
-                col_data[new_col_name].name = new_col_name;
-                col_data[new_col_name].dtype = col_data[new_col_name].dtype;
-                col_data.erase(old_col_name);
-
-                for(string &col : columns) {
-                    if (col == old_col_name) {
-                        col = new_col_name;
-                    }
-                }
-                continue;
-            }
-
-            throw std::out_of_range("Column not found!");
-        }
+    explicit TypedFrame(const DataFrame& df) {
+        load(df, index_sequence_for<Cols...>());
     }
 
     /**
-     * @brief Fills all missing values in the DataFrame with a specified value.
-     * 
-     * @tparam T The type of the fill value (int, double, or string)
-     * @param x The value to use for filling missing entries
-     * @note Applies to all columns in the DataFrame
+     * @brief Converts the TypedFrame to a dynamic DataFrame, with columns in schema order.
      */
-    template <typename T>
-    void fillna(T x) {
-        for (auto it = col_data.begin(); it != col_data.end(); ++it) {
-            for(string &element : it->second.data) {
-                if (element.length() == 0) {
-                    if (is_same<T, int>::value || is_same<T, double>::value) {
-                        element = to_string(x);
-                    } else {
-                        element = x;
-                    }
-                }
-            }
-        }
+    DataFrame to_frame() const {
+        DataFrame df;
+        [&]<size_t... I>(index_sequence<I...>) {
+            (df.assign(string(names[I]), to_column<I>()), ...);
+        }(index_sequence_for<Cols...>());
+        return df;
     }
 
     /**
-     * @brief Removes rows from the DataFrame where the specified column has missing values.
-     * 
-     * @param col The name of the column to check for missing values
-     * @note Removes entire rows across all columns when the specified column has empty values
+     * @brief Returns the number of rows.
      */
-    void dropna(string col) {
-        vector<string> &data = col_data[col].data;
-        vector<int> removed_idx;
+    size_t size() const {
+        return std::get<0>(col_data).size();
+    }
 
-        for(size_t idx = 0; idx < data.size(); idx++) {
-            if (data[idx].length() == 0) {
-                removed_idx.push_back(idx);
-            }
-        }
+    /**
+     * @brief Accesses a column's values by name; unknown names are rejected at compile time.
+     */
+    template <FixedString Name>
+    auto& get() {
+        static_assert(index_of<Name>() < sizeof...(Cols), "Column not in schema");
+        return std::get<index_of<Name>()>(col_data);
+    }
 
-        int jdx = 0;
-        for(size_t idx : removed_idx) {
-            for (auto it = col_data.begin(); it != col_data.end(); ++it) {
-                it->second.data.erase(it->second.data.begin() + idx - jdx);
-            }
-            jdx++;
-        }
+    template <FixedString Name>
+    const auto& get() const {
+        static_assert(index_of<Name>() < sizeof...(Cols), "Column not in schema");
+        return std::get<index_of<Name>()>(col_data);
     }
 
     /**
-     * @brief Saves the DataFrame to a CSV file with customizable options.
-     *
-     * This function allows saving the DataFrame to a specified file with various options:
-     * - Custom separator for columns.
-     * - Option to include or exclude column headers.
-     * - Option to include or exclude row indices.
-     * - Replace missing values with a custom string.
-     * - Save only specific columns if specified.
-     *
-     * @param output_file The path to the output file where the DataFrame will be saved.
-     * @param index Whether to include row indices in the output file (default: true).
-     * @param sep The separator to use between columns (default: ",").
-     * @param header Whether to include column headers in the output file (default: true).
-     * @param na_rep The string to replace missing values (default: "").
-     * @param selected_columns A vector of column names to save. If empty, all columns are saved (default: {}).
-     * @throws std::runtime_error If the file cannot be opened for writing.
-     * @throws std::out_of_range If any of the specified columns in `selected_columns` do not exist.
+     * @brief Builds a dynamic Column from the I-th column.
      */
-    void save_to_csv(
-        const string& output_file,
-        bool index = true,
-        const string& sep = ",",
-        bool header = true,
-        const string& na_rep = "",
-        const vector <string>& selected_columns = {}
-    ) const {
-        std::filesystem::path file_path(output_file);
- 
-        // Create directories if they don't exist
-        if (!file_path.parent_path().empty()) {
-           std::filesystem::create_directories(file_path.parent_path());
-        }
-        ofstream file(output_file);
- 
-        if (!file) {
-           throw runtime_error("Error: Unable to open file for writing!");
-        }
- 
-        // Determine which columns to save
-        vector < string > columns_to_save;
-        if (selected_columns.empty()) {
-           columns_to_save = columns;
-        } else {
-           // Validate selected columns
-           for (const string & col_name: selected_columns) {
-              if (col_data.find(col_name) == col_data.end()) {
-                 throw std::out_of_range("Column not found: " + col_name);
-              }
-              columns_to_save.push_back(col_name);
-           }
-        }
- 
-        // handle header option
-        if (header) {
-           // index option
-           if (index) {
-              file << "index" << sep;
-           }
-           for (size_t i = 0; i < columns_to_save.size(); ++i) {
-              file << columns_to_save[i];
-              if (i < columns_to_save.size() - 1) {
-                 file << sep;
-              }
-           }
-           file << endl;
-        }
- 
-        // Determine the number of rows
-        size_t num_rows = 0;
-        if (!columns_to_save.empty()) {
-           const string & first_col = columns_to_save[0];
-           num_rows = col_data.at(first_col).data.size();
-         }
- 
-        // Write row data
-        for (size_t idx = 0; idx < num_rows; ++idx) {
-           if (index) {
-              file << idx << sep;
-           }
- 
-           for (size_t j = 0; j < columns_to_save.size(); ++j) {
-              const string & col_name = columns_to_save[j];
-              const auto & col = col_data.at(col_name);
- 
-              // Replace missing values with `na_rep` string
-              string value = col.data[idx].empty() ? na_rep : col.data[idx];
-              file << value;
- 
-              if (j < columns_to_save.size() - 1) {
-                 file << sep;
-              }
-           }
-           file << endl;
+    template <size_t I>
+    Column to_column() const {
+        const auto& values = std::get<I>(col_data);
+        Column col;
+        col.name = string(names[I]);
+        col.dtype = CellTraits<value_type<I>>::dtype();
+        vector<string> cells(values.size());
+        for (size_t row = 0; row < values.size(); row++) {
+            cells[row] = CellTraits<value_type<I>>::format(values[row]);
         }
- 
-        file.close();
-        cout << "Data saved successfully to " << output_file << " with separator '" << sep << "'." << endl;
-     }
-
-    friend std::ostream& operator<<(std::ostream& os, const DataFrame& df);
+        col.data = std::move(cells);
+        col.build_statistics();
+        return col;
+    }
 
     /**
-     * @brief Filters the DataFrame using a boolean mask.
-     * 
-     * @param mask Vector of boolean values indicating which rows to include
-     * @return Reference to a new filtered DataFrame
-     * @throws std::out_of_range If the mask size doesn't match the number of data rows
-     * @note Creates a new DataFrame with only the rows where mask is true
-     * @note The header row is always preserved
+     * @brief Calls `fn` with every non-missing value of a column.
      */
-    DataFrame& operator[](const vector<bool> & mask) {
-        size_t data_rows = row_data.size() - 1; // Exclude header
-        if (mask.size() != data_rows) {
-            throw std::out_of_range("Mask size does not match data rows!");
+    template <FixedString Name, typename Fn>
+    void for_each(Fn fn) const {
+        using T = value_type<index_of<Name>()>;
+        for (const auto& value : get<Name>()) {
+            if (!CellTraits<T>::missing(value)) {
+                if constexpr (requires { value.value(); }) {
+                    fn(*value);
+                } else {
+                    fn(value);
+                }
+            }
         }
+    }
 
-        DataFrame *filtered_df = new DataFrame(*this);
+    /**
+     * @brief Sum of a numeric column, skipping missing values.
+     */
+    template <FixedString Name>
+    double sum() const {
+        double total = 0;
+        for_each<Name>([&](auto value) { total += value; });
+        return total;
+    }
 
-        // Preserve the header row
-        filtered_df->row_data.push_back(row_data[0]);
+    /**
+     * @brief Mean of a numeric column, skipping missing values (NaN if there are none).
+     */
+    template <FixedString Name>
+    double mean() const {
+        double total = 0;
+        size_t count = 0;
+        for_each<Name>([&](auto value) {
+            total += value;
+            count++;
+        });
+        return count ? total / count : numeric_limits<double>::quiet_NaN();
+    }
 
-        // Filter data rows 
-        for (size_t i = 0; i < data_rows; ++i) {
-            if (mask[i]) {
-                filtered_df->row_data.push_back(row_data[i + 1]); // Skip header
+    /**
+     * @brief Minimum of a numeric column, skipping missing values (NaN if there are none).
+     */
+    template <FixedString Name>
+    double min() const {
+        double result = numeric_limits<double>::quiet_NaN();
+        for_each<Name>([&](auto value) {
+            if (!(result <= value)) {
+                result = value;
             }
-        }
-
-        // Rebuild columns from filtered data
-        for (const auto& col_name : columns) {
-            Column filtered_col;
-            filtered_col.name = col_name;
-            filtered_col.dtype = col_data.at(col_name).dtype;
+        });
+        return result;
+    }
 
-            // Copy data based on mask (original data indices)
-            for (size_t i = 0; i < data_rows; ++i) {
-                if (mask[i]) {
-                    filtered_col.data.push_back(col_data.at(col_name).data[i]);
-                }
+    /**
+     * @brief Maximum of a numeric column, skipping missing values (NaN if there are none).
+     */
+    template <FixedString Name>
+    double max() const {
+        double result = numeric_limits<double>::quiet_NaN();
+        for_each<Name>([&](auto value) {
+            if (!(result >= value)) {
+                result = value;
             }
-            filtered_df->col_data[col_name] = filtered_col;
-        }
-
-        return *filtered_df;
+        });
+        return result;
     }
 
     /**
-     * @brief Accesses a single column by name.
+     * @brief Builds a row mask from a predicate on a column; missing values never match.
      * 
-     * @param key The name of the column to access
-     * @return Reference to the Column object
-     * @throws std::out_of_range If the column name is not found
+     * @param pred Called with each non-missing value, e.g. `[](double p) { return p > 10; }`
      */
-    Column& operator[](const string& key) {
-        auto it = col_data.find(key);
-        if (it != col_data.end()) {
-            return it->second;
+    template <FixedString Name, typename Pred>
+    Mask mask(Pred pred) const {
+        using T = value_type<index_of<Name>()>;
+        const auto& values = get<Name>();
+        Mask result(values.size());
+        for (size_t row = 0; row < values.size(); row++) {
+            if (!CellTraits<T>::missing(values[row])) {
+                if constexpr (requires { values[row].value(); }) {
+                    result.set(row, pred(*values[row]));
+                } else {
+                    result.set(row, pred(values[row]));
+                }
+            }
         }
-        throw std::out_of_range("Column not found!");
+        return result;
     }
 
     /**
-     * @brief Displays specific columns of the DataFrame.
+     * @brief Returns the rows selected by a mask.
      * 
-     * @param keys Vector of column names to display
-     * @return A dummy Column object (for interface compatibility)
-     * @note This method prints the specified columns and returns a dummy Column
+     * @throws invalid_argument If the mask length does not match the number of rows
      */
-    Column operator[](const vector<string>& keys) {
-        print(0, 0, keys);
-
-        Column dummy;
-        return dummy;
+    TypedFrame operator[](const Mask& rows) const {
+        if (rows.size() != size()) {
+            throw invalid_argument("Invalid argument: mask length does not match the number of rows");
+        }
+        TypedFrame result;
+        [&]<size_t... I>(index_sequence<I...>) {
+            ((std::get<I>(result.col_data).reserve(rows.count())), ...);
+            rows.for_each_set([&](size_t row) {
+                ((std::get<I>(result.col_data).push_back(std::get<I>(col_data)[row])), ...);
+            });
+        }(index_sequence_for<Cols...>());
+        return result;
     }
 };
-
-ostream& operator<<(std::ostream& os, const DataFrame& df) {
-    df.print();
-    return os;
-}
-
-ostream& operator<<(std::ostream& os, const Column& col) {
-    col.print();
-    return os;
-}
+#endif
 
 #endif
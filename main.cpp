@@ -41,4 +41,12 @@ int main() {
     // Filtering 
     DataFrame newData = df[df["Years"] > 30];
     cout << newData << endl;
+
+    // Combine conditions with &, | and ~
+    DataFrame thirties = df[(df["Years"] >= 30) & (df["Years"] < 40)];
+    cout << thirties << endl;
+
+    // Derived columns from column expressions
+    df.assign("Income_k", df["Income"] / 1000);
+    cout << df << endl;
 }
@@ -0,0 +1,3 @@
+g++ tests.cpp -Wall -Werror -pthread -o tests && ./tests && \
+g++ -std=c++20 tests.cpp -Wall -Werror -pthread -o tests && ./tests && \
+g++ -DLESSER_PANDAS_WITH_ZLIB -DLESSER_PANDAS_WITH_ZSTD tests.cpp -Wall -Werror -pthread -o tests -lz -lzstd && ./tests
@@ -0,0 +1,190 @@
+#include "lesser_pandas.h"
+#include <cassert>
+#include <cstdio>
+
+// Regression tests; run with ./test.sh
+
+static void write_file(const string& path, const string& contents) {
+    ofstream out(path);
+    out << contents;
+}
+
+// Cached statistics and zone maps must notice every write to a column's cells.
+static void test_writes_invalidate_statistics() {
+    static_assert(!is_convertible<ColumnData&, vector<string>&>::value,
+                  "column cells must not be writable through a plain vector reference");
+
+    write_file("test_writes.csv", "n\n1\n2\n3\n");
+    DataFrame df("test_writes.csv");
+    remove("test_writes.csv");
+
+    assert(df["n"].max() == 3);
+    assert(df[df["n"] > 50].nrows() == 0);
+
+    df["n"].data.set(1, "100");
+    assert(df["n"].max() == 100);
+    assert(df[df["n"] > 50].nrows() == 1);
+
+    df["n"].data.update([](vector<string>& cells) { cells[0] = "200"; });
+    assert(df["n"].max() == 200);
+    assert(df[df["n"] > 50].nrows() == 2);
+}
+
+// Fields containing the separator, quotes or line breaks survive a save/load round trip.
+static void test_save_load_round_trip() {
+    write_file("test_quoted.csv", "name,note\n\"Smith, Jane\",\"said \"\"hi\"\"\"\nBob,\"two\nlines\"\n");
+    DataFrame df("test_quoted.csv");
+    assert(df["name"].data[0] == "Smith, Jane");
+    assert(df["note"].data[0] == "said \"hi\"");
+
+    df.save_to_csv("test_quoted_out.csv", false);
+    DataFrame loaded("test_quoted_out.csv");
+    remove("test_quoted.csv");
+    remove("test_quoted_out.csv");
+
+    assert(loaded.nrows() == 2);
+    for (const string name : {"name", "note"}) {
+        assert(loaded[name].data.values() == df[name].data.values());
+    }
+}
+
+// Appending to a column whose cells are all missing takes the appended cells' dtype.
+static void test_append_to_all_missing_column() {
+    Column col;
+    col.name = "when";
+    col.data = vector<string>{"", ""};
+    col.dtype = infer_dtype(col.data);
+
+    vector<string> cells = {"2024-01-02", "2024-03-04T05:06:07"};
+    col.append(cells, infer_dtype(cells));
+    assert(col.dtype == "datetime");
+    assert(col.stats().count == 2);
+}
+
+// fillna accepts string fill values as well as numbers.
+static void test_fillna_with_string() {
+    write_file("test_fillna.csv", "name,n\nAlice,1\n,2\n");
+    DataFrame df("test_fillna.csv");
+    remove("test_fillna.csv");
+
+    df.fillna("unknown");
+    assert(df["name"].data[1] == "unknown");
+}
+
+// Integer cells that dtype inference accepts (leading '+' or whitespace) export as values, not nulls.
+static void test_arrow_round_trip_signed_integers() {
+    write_file("test_arrow.csv", "n\n+5\n 7\n3\n-2\n");
+    DataFrame df("test_arrow.csv");
+    remove("test_arrow.csv");
+    assert(df["n"].dtype == "int");
+
+    ArrowSchema schema;
+    ArrowArray array;
+    df.export_arrow(&schema, &array);
+    assert(array.children[0]->null_count == 0);
+
+    DataFrame back = DataFrame::from_arrow(&schema, &array);
+    assert(back["n"].dtype == "int");
+    assert((back["n"].data.values() == vector<string>{"5", "7", "3", "-2"}));
+}
+
+// Resuming from an offset inside the header is rejected instead of reading header bytes as data.
+static void test_append_csv_offset_inside_header() {
+    write_file("test_append.csv", "x,y\n1,2\n3,4\n");
+    DataFrame df("test_append.csv");
+
+    bool threw = false;
+    try {
+        df.append_csv("test_append.csv", 2);
+    } catch (const std::out_of_range&) {
+        threw = true;
+    }
+    assert(threw);
+    assert(df.nrows() == 2);
+
+    df.append_csv("test_append.csv", 4);
+    remove("test_append.csv");
+    assert(df.nrows() == 4);
+}
+
+#if __cplusplus >= 202002L
+// TypedFrame accepts the same integer cells that the dynamic DataFrame infers as "int".
+static void test_typed_frame_integer_grammar() {
+    write_file("test_typed.csv", "a,b\n+5,1.5\n 7,2\n3,\n");
+    TypedFrame<Schema<Col<"a", int64_t>, Col<"b", double>>> typed("test_typed.csv");
+    DataFrame df("test_typed.csv");
+    remove("test_typed.csv");
+
+    assert(df["a"].dtype == "int");
+    assert(typed.size() == 3);
+    assert(typed.sum<"a">() == 15);
+}
+#endif
+
+#if defined(LESSER_PANDAS_WITH_ZLIB) || defined(LESSER_PANDAS_WITH_ZSTD)
+static string read_file(const string& path) {
+    ifstream in(path, ios::binary);
+    return string(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+}
+
+// A compressed save loads back unchanged, also when decoded one byte at a time,
+// and a truncated file is reported instead of loading partially.
+static void test_compression_round_trip(const string& codec, const string& path) {
+    {
+        ofstream out("test_plain.csv");
+        out << "id,name\n";
+        for (int i = 0; i < 50000; i++) {
+            out << i << ",name" << i % 97 << "\n";
+        }
+    }
+    DataFrame df("test_plain.csv");
+    df.save_to_csv(path, false);
+
+    DataFrame loaded(path);
+    assert(loaded.nrows() == df.nrows());
+    assert(loaded["id"].data.values() == df["id"].data.values());
+    assert(loaded["name"].data.values() == df["name"].data.values());
+
+    string expected = read_file("test_plain.csv");
+    unique_ptr<BlockDecoder> decoder = make_decoder(codec, path);
+    string decoded;
+    char byte;
+    while (decoder->read(&byte, 1) == 1) {
+        decoded += byte;
+    }
+    assert(decoded == expected);
+
+    string compressed = read_file(path);
+    write_file(path, compressed.substr(0, compressed.size() / 2));
+    bool threw = false;
+    try {
+        DataFrame truncated(path);
+    } catch (const runtime_error&) {
+        threw = true;
+    }
+    assert(threw);
+
+    remove("test_plain.csv");
+    remove(path.c_str());
+}
+#endif
+
+int main() {
+    test_writes_invalidate_statistics();
+    test_save_load_round_trip();
+    test_append_to_all_missing_column();
+    test_fillna_with_string();
+    test_arrow_round_trip_signed_integers();
+    test_append_csv_offset_inside_header();
+#if __cplusplus >= 202002L
+    test_typed_frame_integer_grammar();
+#endif
+#ifdef LESSER_PANDAS_WITH_ZLIB
+    test_compression_round_trip("gzip", "test_round_trip.csv.gz");
+#endif
+#ifdef LESSER_PANDAS_WITH_ZSTD
+    test_compression_round_trip("zstd", "test_round_trip.csv.zst");
+#endif
+    cout << "All tests passed" << endl;
+    return 0;
+}